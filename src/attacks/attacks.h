@@ -30,6 +30,8 @@
 
 #if SPJ_HAS_BMI2
 #include "bmi2/attacks.h"
+#elif SPJ_KINDERGARTEN_ROOKS
+#include "kindergarten/attacks.h"
 #else
 #include "black_magic/attacks.h"
 #endif
@@ -165,7 +167,28 @@ namespace stormphranj::attacks
 		return attacks[static_cast<usize>(src)];
 	}
 
-	inline auto getNonPawnPieceAttacks(PieceType piece, Square src, Bitboard occupancy = Bitboard{})
+	// Set-wise attacks of every piece in the set at once, from shifts rather than a table lookup
+	// per piece. Only worth it for pieces that can be numerous - alfils and knights cannot be
+	// promoted to, so there are at most two of each, but every pawn can become a ferz
+	constexpr auto getFerzSetAttacks(Bitboard ferzes) -> Bitboard
+	{
+		// sources are masked off the file they would wrap from up front,
+		// so the jumps towards each side of the board share a mask
+		const auto left = ferzes & ~boards::FileA;
+		const auto right = ferzes & ~boards::FileH;
+
+		return (left << 7) | (left >> 9)
+			| (right << 9) | (right >> 7);
+	}
+
+	constexpr auto getPawnSetAttacks(Bitboard pawns, Color color) -> Bitboard
+	{
+		if (color == Color::Black)
+			return pawns.shiftDownLeft() | pawns.shiftDownRight();
+		else return pawns.shiftUpLeft() | pawns.shiftUpRight();
+	}
+
+	constexpr auto getNonPawnPieceAttacks(PieceType piece, Square src, Bitboard occupancy = Bitboard{})
 	{
 		assert(piece != PieceType::None);
 		assert(piece != PieceType::Pawn);
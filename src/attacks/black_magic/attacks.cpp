@@ -18,14 +18,14 @@
 
 #include "../attacks.h"
 
-#if !SPJ_HAS_BMI2
+#if !SPJ_HAS_BMI2 && !SPJ_KINDERGARTEN_ROOKS
 namespace stormphranj::attacks
 {
 	using namespace black_magic;
 
 	namespace
 	{
-		auto generateRookAttacks()
+		constexpr auto generateRookAttacks()
 		{
 			std::array<Bitboard, RookData.tableSize> dst{};
 
@@ -33,21 +33,46 @@ namespace stormphranj::attacks
 			{
 				const auto &data = RookData.data[square];
 
-				const auto invMask = ~data.mask;
-				const auto maxEntries = 1 << invMask.popcount();
+				const auto up = internal::rookRay(static_cast<Square>(square), offsets::Up);
+				const auto down = internal::rookRay(static_cast<Square>(square), offsets::Down);
+				const auto left = internal::rookRay(static_cast<Square>(square), offsets::Left);
+				const auto right = internal::rookRay(static_cast<Square>(square), offsets::Right);
 
-				for (u32 i = 0; i < maxEntries; ++i)
+				const auto magic = Magics[square];
+				const auto shift = Shifts[square];
+
+				// raw pointers and integers, as every std::array access and
+				// Bitboard operation is comparatively expensive at compile time
+				auto *table = dst.data() + data.offset;
+
+				std::array<u64, 64> upOccupancies{};
+				std::array<u64, 64> upAttacks{};
+
+				for (u32 u = 0; u < up.count; ++u)
 				{
-					const auto occupancy = util::pdep(i, invMask);
-					const auto idx = getIdx(occupancy, static_cast<Square>(square));
+					upOccupancies[u] = up.occupancies[u];
+					upAttacks[u] = up.attacks[u];
+				}
 
-					if (!dst[data.offset + idx].empty())
-						continue;
+				const auto *upOccupancy = upOccupancies.data();
+				const auto *upAttack = upAttacks.data();
 
-					for (const auto dir : {offsets::Up, offsets::Down, offsets::Left, offsets::Right})
+				for (u32 d = 0; d < down.count; ++d)
+				{
+					for (u32 l = 0; l < left.count; ++l)
 					{
-						dst[data.offset + idx]
-							|= internal::generateSlidingAttacks(static_cast<Square>(square), dir, occupancy);
+						for (u32 r = 0; r < right.count; ++r)
+						{
+							const u64 occupancy = data.mask | down.occupancies[d]
+								| left.occupancies[l] | right.occupancies[r];
+							const u64 attacks = down.attacks[d] | left.attacks[l] | right.attacks[r];
+
+							for (u32 u = 0; u < up.count; ++u)
+							{
+								const auto idx = ((occupancy | upOccupancy[u]) * magic) >> shift;
+								table[idx] = attacks | upAttack[u];
+							}
+						}
 					}
 				}
 			}
@@ -56,6 +81,6 @@ namespace stormphranj::attacks
 		}
 	}
 
-	const std::array<Bitboard, RookData.tableSize> RookAttacks = generateRookAttacks();
+	constexpr std::array<Bitboard, RookData.tableSize> RookAttacks = generateRookAttacks();
 }
-#endif // !SPJ_HAS_BMI2
+#endif // !SPJ_HAS_BMI2 && !SPJ_KINDERGARTEN_ROOKS
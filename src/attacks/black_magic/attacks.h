@@ -30,9 +30,11 @@
 
 namespace stormphranj::attacks
 {
+	constexpr auto RookBackendName = "black magic";
+
 	extern const std::array<Bitboard, black_magic::RookData.tableSize> RookAttacks;
 
-	[[nodiscard]] inline auto getIdx(Bitboard occupancy, Square src)
+	[[nodiscard]] constexpr auto getIdx(Bitboard occupancy, Square src)
 	{
 		const auto s = static_cast<i32>(src);
 
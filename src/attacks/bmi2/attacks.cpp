@@ -25,27 +25,67 @@ namespace stormphranj::attacks
 
 	namespace
 	{
-		auto generateRookAttacks()
+		// pext distributes over or, so each ray's occupancies
+		// and attacks can be compressed separately and combined
+		struct CompressedRookRay
+		{
+			u32 count;
+			std::array<u16, 64> indices;
+			std::array<u16, 64> attacks;
+		};
+
+		constexpr auto compressRookRay(Square src, i32 dir, const RookSquareData &data)
+		{
+			const auto ray = internal::rookRay(src, dir);
+
+			CompressedRookRay dst{};
+
+			dst.count = ray.count;
+
+			for (u32 i = 0; i < ray.count; ++i)
+			{
+				dst.indices[i] = static_cast<u16>(util::pext(ray.occupancies[i], data.srcMask));
+				dst.attacks[i] = static_cast<u16>(util::pext(ray.attacks[i], data.dstMask));
+			}
+
+			return dst;
+		}
+
+		constexpr auto generateRookAttacks()
 		{
 			std::array<u16, RookData.tableSize> dst{};
 
 			for (u32 square = 0; square < 64; ++square)
 			{
 				const auto &data = RookData.data[square];
-				const auto entries = 1 << data.srcMask.popcount();
 
-				for (u32 i = 0; i < entries; ++i)
-				{
-					const auto occupancy = util::pdep(i, data.srcMask);
+				const auto up = compressRookRay(static_cast<Square>(square), offsets::Up, data);
+				const auto down = compressRookRay(static_cast<Square>(square), offsets::Down, data);
+				const auto left = compressRookRay(static_cast<Square>(square), offsets::Left, data);
+				const auto right = compressRookRay(static_cast<Square>(square), offsets::Right, data);
 
-					Bitboard attacks{};
+				// raw pointers, as every std::array access is
+				// comparatively expensive at compile time
+				auto *table = dst.data() + data.offset;
 
-					for (const auto dir : {offsets::Up, offsets::Down, offsets::Left, offsets::Right})
+				const auto *upIndices = up.indices.data();
+				const auto *upAttacks = up.attacks.data();
+
+				for (u32 d = 0; d < down.count; ++d)
+				{
+					for (u32 l = 0; l < left.count; ++l)
 					{
-						attacks |= internal::generateSlidingAttacks(static_cast<Square>(square), dir, occupancy);
-					}
+						for (u32 r = 0; r < right.count; ++r)
+						{
+							const auto idx = down.indices[d] | left.indices[l] | right.indices[r];
+							const auto attacks = down.attacks[d] | left.attacks[l] | right.attacks[r];
 
-					dst[data.offset + i] = static_cast<u16>(util::pext(attacks, data.dstMask));
+							for (u32 u = 0; u < up.count; ++u)
+							{
+								table[idx | upIndices[u]] = static_cast<u16>(attacks | upAttacks[u]);
+							}
+						}
+					}
 				}
 			}
 
@@ -53,6 +93,6 @@ namespace stormphranj::attacks
 		}
 	}
 
-	const std::array<u16, RookData.tableSize> RookAttacks = generateRookAttacks();
+	constexpr std::array<u16, RookData.tableSize> RookAttacks = generateRookAttacks();
 }
 #endif // SPJ_HAS_BMI2
@@ -30,6 +30,8 @@
 
 namespace stormphranj::attacks
 {
+	constexpr auto RookBackendName = "pext/pdep";
+
 	extern const std::array<u16, bmi2::RookData.tableSize> RookAttacks;
 
 	inline auto getRookAttacks(Square src, Bitboard occupancy) -> Bitboard
@@ -0,0 +1,113 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../types.h"
+
+#include <array>
+
+#include "../../core.h"
+#include "../../bitboard.h"
+#include "../util.h"
+
+namespace stormphranj::attacks
+{
+	constexpr auto RookBackendName = "kindergarten";
+
+	// Kindergarten rook attacks - ranks and files are looked up separately in two small
+	// tables indexed by the six inner occupancy bits of the line, 4.5 KiB in total, which
+	// fits in L1 alongside everything else, where magic tables do not. No pext required
+	namespace kindergarten
+	{
+		// maps the inner six squares of the a-file to the top six bits
+		constexpr u64 FileMagic = U64(0x0004081020408000);
+
+		[[nodiscard]] constexpr auto rankIdx(Bitboard occupancy, i32 rank) -> u32
+		{
+			return (static_cast<u64>(occupancy) >> (rank * 8 + 1)) & 0x3F;
+		}
+
+		[[nodiscard]] constexpr auto fileIdx(Bitboard occupancy, i32 file) -> u32
+		{
+			return (((static_cast<u64>(occupancy) >> file) & boards::FileA) * FileMagic) >> 58;
+		}
+
+		// attacks along the first rank, by file and rank occupancy
+		constexpr auto RankAttacks = []
+		{
+			std::array<std::array<u8, 64>, 8> dst{};
+
+			for (i32 file = 0; file < 8; ++file)
+			{
+				for (u64 inner = 0; inner < 64; ++inner)
+				{
+					const auto square = toSquare(0, file);
+					const auto occupancy = Bitboard{inner << 1};
+
+					const auto attacks = internal::generateSlidingAttacks(square, offsets::Left, occupancy)
+						| internal::generateSlidingAttacks(square, offsets::Right, occupancy);
+
+					dst[file][rankIdx(occupancy, 0)] = static_cast<u8>(attacks);
+				}
+			}
+
+			return dst;
+		}();
+
+		// attacks along the a-file, by rank and file occupancy
+		constexpr auto FileAttacks = []
+		{
+			std::array<std::array<Bitboard, 64>, 8> dst{};
+
+			for (i32 rank = 0; rank < 8; ++rank)
+			{
+				for (u64 inner = 0; inner < 64; ++inner)
+				{
+					const auto square = toSquare(rank, 0);
+
+					Bitboard occupancy{};
+
+					for (i32 i = 0; i < 6; ++i)
+					{
+						if (inner & (U64(1) << i))
+							occupancy |= squareBit(toSquare(i + 1, 0));
+					}
+
+					dst[rank][fileIdx(occupancy, 0)]
+						= internal::generateSlidingAttacks(square, offsets::Up, occupancy)
+						| internal::generateSlidingAttacks(square, offsets::Down, occupancy);
+				}
+			}
+
+			return dst;
+		}();
+	}
+
+	[[nodiscard]] inline auto getRookAttacks(Square src, Bitboard occupancy) -> Bitboard
+	{
+		const auto rank = squareRank(src);
+		const auto file = squareFile(src);
+
+		const auto rankAttacks = Bitboard{static_cast<u64>(
+			kindergarten::RankAttacks[file][kindergarten::rankIdx(occupancy, rank)]) << (rank * 8)};
+		const auto fileAttacks = kindergarten::FileAttacks[rank][kindergarten::fileIdx(occupancy, file)] << file;
+
+		return rankAttacks | fileAttacks;
+	}
+}
@@ -25,6 +25,7 @@
 #include "../core.h"
 #include "../bitboard.h"
 #include "../util/cemath.h"
+#include "../util/bits.h"
 
 namespace stormphranj::attacks
 {
@@ -106,4 +107,34 @@ namespace stormphranj::attacks
 
 		return dst;
 	}
+
+	namespace internal
+	{
+		struct RookRay
+		{
+			u32 count;
+			std::array<Bitboard, 64> occupancies;
+			std::array<Bitboard, 64> attacks;
+		};
+
+		// Every occupancy of the squares that can block a rook on src in one direction, and the
+		// attacks for each. The four rays are independent, so a full rook attack table can be
+		// filled by combining one entry of each, which is cheap enough to do at compile time
+		constexpr auto rookRay(Square src, i32 dir)
+		{
+			RookRay dst{};
+
+			const auto mask = generateSlidingAttacks(src, dir, 0) & ~edges(dir);
+
+			dst.count = 1 << mask.popcount();
+
+			for (u32 i = 0; i < dst.count; ++i)
+			{
+				dst.occupancies[i] = util::pdep(i, mask);
+				dst.attacks[i] = generateSlidingAttacks(src, dir, dst.occupancies[i]);
+			}
+
+			return dst;
+		}
+	}
 }
@@ -19,12 +19,21 @@
 #include "bench.h"
 
 #include <array>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <memory>
 
 #include "position/position.h"
+#include "movegen.h"
+#include "see.h"
+#include "attacks/attacks.h"
+#include "limit/trivial.h"
+#include "profile.h"
 
 namespace stormphranj::bench
 {
-	auto run(search::Searcher &searcher, i32 depth) -> void
+	namespace
 	{
 		const std::array Fens { // taken from random games
 			"r5r1/1k6/1pqb4/1Bppn1p1/P1n1p2p/P1N1P2P/2KQ1p2/1RBR2N1 w - - 0 45",
@@ -48,12 +57,21 @@ namespace stormphranj::bench
 			"8/2p4p/b7/4Qp2/4kP2/P1K5/8/8 b - - 15 55",
 			"8/4k3/4R3/2PK4/1P3Nn1/P2PPn2/5r2/8 b - - 2 58"
 		};
+	}
 
+	auto run(search::Searcher &searcher, i32 depth) -> void
+	{
 		usize nodes{};
+		usize nnueEvals{};
+		usize ttEvals{};
 		f64 time{};
 
+		search::stats::SearchStats stats{};
+
 		Position pos{};
 
+		profile::reset();
+
 		for (const auto &fen : Fens)
 		{
 			if (!pos.resetFromFen(fen))
@@ -65,10 +83,225 @@ namespace stormphranj::bench
 			searcher.runBench(data, pos, depth);
 
 			nodes += data.search.nodes;
+			nnueEvals += data.search.nnueEvals;
+			ttEvals += data.search.ttEvals;
+			stats += data.stats;
 			time += data.time;
 		}
 
+		// printed first, as the last line must stay the node count for openbench
+		search::stats::print(stats);
+		profile::print();
+
 		std::cout << "info string " << time << " seconds" << std::endl;
+		std::cout << "info string " << ttEvals << " of " << (nnueEvals + ttEvals)
+			<< " static evals taken from tt, avoiding nnue" << std::endl;
 		std::cout << nodes << " nodes " << static_cast<usize>(static_cast<f64>(nodes) / time) << " nps" << std::endl;
 	}
+
+	auto runSmp(search::Searcher &searcher, i32 depth) -> void
+	{
+		const auto prevAbdada = searcher.abdada();
+
+		// without, with
+		std::array<f64, 2> times{};
+		std::array<usize, 2> nodes{};
+
+		Position pos{};
+
+		for (const bool abdada : {false, true})
+		{
+			searcher.setAbdada(abdada);
+
+			for (const auto &fen : Fens)
+			{
+				if (!pos.resetFromFen(fen))
+					return;
+
+				searcher.newGame();
+
+				const auto start = util::g_timer.time();
+
+				searcher.startSearch(pos, depth, std::make_unique<limit::InfiniteLimiter>());
+
+				while (searcher.searching())
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds{1});
+				}
+
+				times[abdada] += util::g_timer.time() - start;
+				nodes[abdada] += searcher.totalNodes();
+			}
+		}
+
+		searcher.setAbdada(prevAbdada);
+
+		std::cout << "info string time to depth " << depth << " without abdada: " << times[0] << " seconds" << std::endl;
+		std::cout << "info string time to depth " << depth << " with abdada: " << times[1] << " seconds" << std::endl;
+		std::cout << "info string abdada speedup: " << (times[0] / times[1]) << std::endl;
+
+		for (const bool abdada : {false, true})
+		{
+			std::cout << "info string nps " << (abdada ? "with" : "without") << " abdada: "
+				<< static_cast<usize>(static_cast<f64>(nodes[abdada]) / times[abdada]) << std::endl;
+		}
+	}
+
+	auto runMoves(u32 iterations) -> void
+	{
+		usize moves{};
+		f64 makeTime{};
+
+		usize nodes{};
+		f64 movegenTime{};
+
+		usize evasionNodes{};
+		f64 evasionTime{};
+
+		usize threatCalcs{};
+		f64 threatTime{};
+		u64 threatSum{};
+
+		usize rookLookups{};
+		f64 rookTime{};
+		u64 rookSum{};
+
+		usize seeMoves{};
+		usize seeGood{};
+		f64 seeTime{};
+
+		Position pos{};
+
+		auto history = std::make_unique<HistoryTable>();
+		MovegenData data{};
+
+		for (const auto &fen : Fens)
+		{
+			if (!pos.resetFromFen(fen))
+				return;
+
+			ScoredMoveList legal{};
+			generateAll(legal, pos);
+
+			auto start = util::g_timer.time();
+
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				for (const auto [move, score] : legal)
+				{
+					pos.applyMoveUnchecked<false>(move, nullptr);
+					pos.popMove<false>(nullptr);
+				}
+			}
+
+			makeTime += util::g_timer.time() - start;
+			moves += static_cast<usize>(iterations) * legal.size();
+
+			start = util::g_timer.time();
+
+			// full staged generation and ordering, as at an interior search node
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				MoveGenerator<false> generator{pos, NullMove, data, NullMove, {}, {}, history.get()};
+				while (generator.next()) {}
+			}
+
+			movegenTime += util::g_timer.time() - start;
+			nodes += iterations;
+
+			// the same, for every position reachable with a checking move
+			for (const auto [move, score] : legal)
+			{
+				pos.applyMoveUnchecked<false>(move, nullptr);
+
+				if (pos.isCheck())
+				{
+					start = util::g_timer.time();
+
+					for (u32 i = 0; i < iterations; ++i)
+					{
+						MoveGenerator<false> generator{pos, NullMove, data, NullMove, {}, {}, history.get()};
+						while (generator.next()) {}
+					}
+
+					evasionTime += util::g_timer.time() - start;
+					evasionNodes += iterations;
+				}
+
+				pos.popMove<false>(nullptr);
+			}
+
+			// volatile so that the calculation cannot be hoisted out of the loop
+			const Position *volatile threatPos = &pos;
+
+			start = util::g_timer.time();
+
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				threatSum += threatPos->calcThreats();
+			}
+
+			threatTime += util::g_timer.time() - start;
+			threatCalcs += iterations;
+
+			// rook attacks from every square with this position's occupancy - volatile
+			// so that the lookups cannot be hoisted out of the loop
+			const volatile u64 occupancySrc = pos.bbs().occupancy();
+
+			start = util::g_timer.time();
+
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				const auto occupancy = Bitboard{occupancySrc};
+
+				for (i32 square = 0; square < 64; ++square)
+				{
+					rookSum += attacks::getRookAttacks(static_cast<Square>(square), occupancy);
+				}
+			}
+
+			rookTime += util::g_timer.time() - start;
+			rookLookups += static_cast<usize>(iterations) * 64;
+
+			// every noisy move in every child position
+			const auto seeIterations = std::max<u32>(iterations / 16, 1);
+
+			for (const auto [move, score] : legal)
+			{
+				pos.applyMoveUnchecked<false>(move, nullptr);
+
+				ScoredMoveList noisy{};
+				generateNoisy(noisy, pos);
+
+				start = util::g_timer.time();
+
+				for (u32 i = 0; i < seeIterations; ++i)
+				{
+					for (const auto [noisyMove, noisyScore] : noisy)
+					{
+						seeGood += see::see(pos, noisyMove);
+					}
+				}
+
+				seeTime += util::g_timer.time() - start;
+				seeMoves += static_cast<usize>(seeIterations) * noisy.size();
+
+				pos.popMove<false>(nullptr);
+			}
+		}
+
+		std::cout << "info string make/unmake: " << moves << " moves in " << makeTime << " seconds, "
+			<< static_cast<usize>(static_cast<f64>(moves) / makeTime) << " moves/s" << std::endl;
+		std::cout << "info string movegen: " << nodes << " nodes in " << movegenTime << " seconds, "
+			<< (movegenTime * 1e9 / static_cast<f64>(nodes)) << " ns/node" << std::endl;
+		std::cout << "info string evasions: " << evasionNodes << " nodes in " << evasionTime << " seconds, "
+			<< (evasionTime * 1e9 / static_cast<f64>(evasionNodes)) << " ns/node" << std::endl;
+		std::cout << "info string threats: " << threatCalcs << " calls in " << threatTime << " seconds, "
+			<< (threatTime * 1e9 / static_cast<f64>(threatCalcs)) << " ns/call, checksum " << threatSum << std::endl;
+		std::cout << "info string rook attacks (" << attacks::RookBackendName << "): " << rookLookups
+			<< " lookups in " << rookTime << " seconds, " << (rookTime * 1e9 / static_cast<f64>(rookLookups))
+			<< " ns/lookup, checksum " << rookSum << std::endl;
+		std::cout << "info string see: " << seeMoves << " moves in " << seeTime << " seconds, "
+			<< (seeTime * 1e9 / static_cast<f64>(seeMoves)) << " ns/move, " << seeGood << " good" << std::endl;
+	}
 }
@@ -30,5 +30,17 @@ namespace stormphranj::bench
 	constexpr i32 DefaultBenchDepth = 20;
 #endif
 
+	constexpr i32 DefaultSmpBenchDepth = 16;
+	constexpr u32 DefaultSmpBenchThreads = 4;
+
+	constexpr u32 DefaultMoveBenchIterations = 100000;
+
 	auto run(search::Searcher &searcher, i32 depth = DefaultBenchDepth) -> void;
+
+	// Time to depth and nps with the searcher's current thread count, with and without ABDADA
+	auto runSmp(search::Searcher &searcher, i32 depth = DefaultSmpBenchDepth) -> void;
+
+	// Make/unmake throughput over every legal move in each bench position without nnue
+	// updates, and the cost of staged move generation and ordering in each position
+	auto runMoves(u32 iterations = DefaultMoveBenchIterations) -> void;
 }
@@ -29,54 +29,75 @@ namespace stormphranj::cuckoo
 	// https://web.archive.org/web/20201107002606/https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
 	// Implementation based on Stockfish's
 
-	std::array<u64, 8192> keys{};
-	std::array<Move, 8192> moves{};
-
-	void init()
+	namespace
 	{
-		u32 count = 0;
+		struct Tables
+		{
+			std::array<u64, 8192> keys;
+			std::array<Move, 8192> moves;
+		};
 
-		// skip pawns
-		for (u32 p = static_cast<u32>(Piece::BlackAlfil);
-			p < static_cast<u32>(Piece::None);
-			++p)
+		constexpr auto generateTables()
 		{
-			const auto piece = static_cast<Piece>(p);
+			Tables dst{};
+
+			u32 count = 0;
 
-			for (u32 s0 = 0; s0 < 64; ++s0)
+			// skip pawns
+			for (u32 p = static_cast<u32>(Piece::BlackAlfil);
+				p < static_cast<u32>(Piece::None);
+				++p)
 			{
-				const auto square0 = static_cast<Square>(s0);
+				const auto piece = static_cast<Piece>(p);
 
-				for (u32 s1 = s0 + 1; s1 < 64; ++s1)
+				for (u32 s0 = 0; s0 < 64; ++s0)
 				{
-					const auto square1 = static_cast<Square>(s1);
+					const auto square0 = static_cast<Square>(s0);
 
-					if (!attacks::getNonPawnPieceAttacks(pieceType(piece), square0)[square1])
-						continue;
+					// the rook tables are not usable at compile time
+					const auto targets = pieceType(piece) == PieceType::Rook
+						? attacks::EmptyBoardRooks[s0]
+						: attacks::getNonPawnPieceAttacks(pieceType(piece), square0);
 
-					auto move = Move::standard(square0, square1);
-					auto key = keys::pieceSquare(piece, square0)
-						^ keys::pieceSquare(piece, square1)
-						^ keys::color();
+					for (u32 s1 = s0 + 1; s1 < 64; ++s1)
+					{
+						const auto square1 = static_cast<Square>(s1);
 
-					u32 slot = h1(key);
+						if (!targets[square1])
+							continue;
 
-					while (true)
-					{
-						std::swap(keys[slot], key);
-						std::swap(moves[slot], move);
+						auto move = Move::standard(square0, square1);
+						auto key = keys::pieceSquare(piece, square0)
+							^ keys::pieceSquare(piece, square1)
+							^ keys::color();
 
-						if (move == NullMove)
-							break;
+						u32 slot = h1(key);
 
-						slot = slot == h1(key) ? h2(key) : h1(key);
-					}
+						while (true)
+						{
+							std::swap(dst.keys[slot], key);
+							std::swap(dst.moves[slot], move);
 
-					++count;
+							if (move == NullMove)
+								break;
+
+							slot = slot == h1(key) ? h2(key) : h1(key);
+						}
+
+						++count;
+					}
 				}
 			}
+
+			// one entry per pair of squares a non-pawn piece can move between
+			assert(count == 1992);
+
+			return dst;
 		}
 
-		assert(count == 3668);
+		constexpr auto Generated = generateTables();
 	}
+
+	constexpr std::array<u64, 8192> keys = Generated.keys;
+	constexpr std::array<Move, 8192> moves = Generated.moves;
 }
@@ -36,8 +36,6 @@ namespace stormphranj::cuckoo
 		return static_cast<usize>((key >> 16) & 0x1FFF);
 	}
 
-	extern std::array<u64, 8192> keys;
-	extern std::array<Move, 8192> moves;
-
-	void init();
+	extern const std::array<u64, 8192> keys;
+	extern const std::array<Move, 8192> moves;
 }
@@ -0,0 +1,111 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "book.h"
+
+#include <iostream>
+#include <string_view>
+#include <algorithm>
+
+#include "../util/split.h"
+
+namespace stormphranj::datagen
+{
+	namespace
+	{
+		constexpr u32 MaxSampleAttempts = 64;
+
+		inline auto isNumber(const std::string &str)
+		{
+			return !str.empty() && std::ranges::all_of(str, [](char c) { return c >= '0' && c <= '9'; });
+		}
+
+		// EPDs only carry the first four FEN fields, followed by opcodes
+		auto epdToFen(std::string_view line) -> std::string
+		{
+			const auto tokens = split::split(std::string{line}, ' ');
+
+			if (tokens.size() < 4)
+				return {};
+
+			auto fen = tokens[0] + ' ' + tokens[1] + ' ' + tokens[2] + ' ' + tokens[3];
+
+			if (tokens.size() >= 6 && isNumber(tokens[4]) && isNumber(tokens[5]))
+				fen += ' ' + tokens[4] + ' ' + tokens[5];
+			else fen += " 0 1";
+
+			return fen;
+		}
+	}
+
+	auto EpdBook::open(const std::filesystem::path &path) -> bool
+	{
+		if (!m_file.open(path, util::AccessPattern::Random))
+			return false;
+
+		if (m_file.size() == 0)
+		{
+			std::cerr << "book " << path << " is empty" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	auto EpdBook::sample(util::rng::Jsf64Rng &rng, Position &pos) const -> bool
+	{
+		const auto data = m_file.data();
+
+		const auto *chars = reinterpret_cast<const char *>(data.data());
+		const auto size = data.size();
+
+		for (u32 attempt = 0; attempt < MaxSampleAttempts; ++attempt)
+		{
+			const auto offset = static_cast<usize>(
+				(static_cast<u128>(rng.nextU64()) * static_cast<u128>(size)) >> 64);
+
+			auto begin = offset;
+			while (begin > 0 && chars[begin - 1] != '\n')
+			{
+				--begin;
+			}
+
+			auto end = offset;
+			while (end < size && chars[end] != '\n')
+			{
+				++end;
+			}
+
+			auto line = std::string_view{chars + begin, end - begin};
+
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			if (line.empty() || line.front() == '#')
+				continue;
+
+			if (const auto fen = epdToFen(line);
+				!fen.empty() && pos.resetFromFen(fen, true))
+				return true;
+
+			m_invalidLines.fetch_add(1, std::memory_order::relaxed);
+		}
+
+		return false;
+	}
+}
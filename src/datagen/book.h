@@ -0,0 +1,59 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <filesystem>
+#include <atomic>
+
+#include "../position/position.h"
+#include "../util/mmap.h"
+#include "../util/rng.h"
+
+namespace stormphranj::datagen
+{
+	// EPD/FEN book that datagen games can start from. The file is memory mapped
+	// and sampled in place, so arbitrarily large books do not need to fit in RAM
+	class EpdBook
+	{
+	public:
+		EpdBook() = default;
+		~EpdBook() = default;
+
+		auto open(const std::filesystem::path &path) -> bool;
+
+		// Picks a random line from the book and loads it into pos.
+		// Lines are picked with probability proportional to their length,
+		// which is close enough to uniform for books of FENs or EPDs
+		// Invalid lines are skipped without printing anything, and only counted
+		auto sample(util::rng::Jsf64Rng &rng, Position &pos) const -> bool;
+
+		// number of invalid lines skipped while sampling, across all threads
+		[[nodiscard]] inline auto invalidLines() const
+		{
+			return m_invalidLines.load(std::memory_order::relaxed);
+		}
+
+	private:
+		util::MappedFile m_file{};
+
+		mutable std::atomic<usize> m_invalidLines{0};
+	};
+}
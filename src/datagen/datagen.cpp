@@ -43,6 +43,8 @@
 #include "format.h"
 #include "viri_binpack.h"
 #include "marlinformat.h"
+#include "stats.h"
+#include "book.h"
 
 // abandon hope all ye who enter here
 // my search was not written with this in mind
@@ -122,10 +124,17 @@ namespace stormphranj::datagen
 		constexpr u32 WinAdjMaxPlies = 5;
 		constexpr u32 DrawAdjMaxPlies = 10;
 
+		// a game is usually well under a million nodes at the datagen node limits,
+		// so this holds most of a game's searches while staying mostly in cache
+		constexpr usize DatagenTtSize = 4;
+
 		constexpr i32 ReportInterval = 1024;
 
+		constexpr f64 StatsReportInterval = 10.0;
+
 		template <OutputFormat Format>
-		auto runThread(u32 id, u32 games, u64 seed, const std::filesystem::path &outDir)
+		auto runThread(u32 id, u32 games, u64 seed, const std::filesystem::path &outDir,
+			const EpdBook *book, u32 randomMoves, ThreadStats &stats)
 		{
 			const auto outFile = outDir / (std::to_string(id) + "." + Format::Extension);
 			std::ofstream out{outFile, std::ios::binary | std::ios::app};
@@ -141,17 +150,25 @@ namespace stormphranj::datagen
 			auto limiterPtr = std::make_unique<DatagenNodeLimiter>(id);
 			auto &limiter = *limiterPtr;
 
-			search::Searcher searcher{};
+			// The TT is deliberately never cleared between games. It is aged after
+			// every search, so entries from previous games are replaced first, and
+			// the ones that survive are still valid for transpositions into them
+			search::Searcher searcher{DatagenTtSize};
 			searcher.setLimiter(std::move(limiterPtr));
 
 			auto thread = std::make_unique<search::ThreadData>();
 			thread->datagen = true;
 
-			const auto resetSearch = [&searcher, &thread]()
+			// keeps the TT and history
+			const auto resetSearch = [&thread]()
 			{
-				searcher.newGame();
 				thread->search = search::SearchData{};
 				std::fill(thread->stack.begin(), thread->stack.end(), search::SearchStackEntry{});
+			};
+
+			const auto resetGame = [&thread, &resetSearch]()
+			{
+				resetSearch();
 				thread->history.clear();
 			};
 
@@ -163,35 +180,34 @@ namespace stormphranj::datagen
 
 			for (i32 game = 0; game < games && !s_stop.load(std::memory_order::seq_cst); ++game)
 			{
-				resetSearch();
+				resetGame();
 
-				thread->pos.resetToStarting();
+				if (book)
+				{
+					if (!book->sample(rng, thread->pos))
+					{
+						std::cerr << "thread " << id << ": failed to find a valid position in book" << std::endl;
+						return;
+					}
+				}
+				else thread->pos.resetToStarting();
 
-				const auto moveCount = 8 + (rng.nextU32() >> 31);
+				const auto moveCount = randomMoves + (rng.nextU32() >> 31);
 
-				bool legalFound = false;
+				bool legalFound = true;
 
 				for (i32 i = 0; i < moveCount; ++i)
 				{
 					ScoredMoveList moves{};
 					generateAll(moves, thread->pos);
 
-					std::shuffle(moves.begin(), moves.end(), rng);
-
-					legalFound = false;
-
-					for (const auto [move, score] : moves)
-					{
-						if (thread->pos.isLegal(move))
-						{
-							thread->pos.applyMoveUnchecked<false>(move, nullptr);
-							legalFound = true;
-							break;
-						}
-					}
+					legalFound = !moves.empty();
 
 					if (!legalFound)
 						break;
+
+					std::shuffle(moves.begin(), moves.end(), rng);
+					thread->pos.applyMoveUnchecked<false>(moves[0].move, nullptr);
 				}
 
 				if (!legalFound)
@@ -211,6 +227,7 @@ namespace stormphranj::datagen
 				limiter.setHardNodeLimit(VerificationHardNodeLimit);
 
 				const auto [firstScore, normFirstScore] = searcher.runDatagenSearch(*thread);
+				ThreadStats::add(stats.nodes, thread->search.nodes);
 
 				thread->maxDepth = MaxDepth;
 				limiter.setSoftNodeLimit(DatagenSoftNodeLimit);
@@ -218,6 +235,7 @@ namespace stormphranj::datagen
 
 				if (std::abs(normFirstScore) > VerificationScoreLimit)
 				{
+					ThreadStats::add(stats.verificationRejections, 1);
 					--game;
 					continue;
 				}
@@ -229,10 +247,14 @@ namespace stormphranj::datagen
 				u32 drawPlies{};
 
 				std::optional<Outcome> outcome{};
+				auto reason = AdjudicationReason::Mate;
+
+				u32 plies{};
 
 				while (true)
 				{
 					const auto [score, normScore] = searcher.runDatagenSearch(*thread);
+					ThreadStats::add(stats.nodes, thread->search.nodes);
 					thread->search = search::SearchData{};
 
 					const auto move = thread->rootPv.moves[0];
@@ -256,7 +278,10 @@ namespace stormphranj::datagen
 					assert(thread->pos.boards().pieceAt(move.src()) != Piece::None);
 
 					if (std::abs(score) > ScoreWin)
+					{
 						outcome = score > 0 ? Outcome::WhiteWin : Outcome::WhiteLoss;
+						reason = AdjudicationReason::Mate;
+					}
 					else
 					{
 						if (normScore > WinAdjMinScore)
@@ -285,16 +310,26 @@ namespace stormphranj::datagen
 						}
 
 						if (winPlies >= WinAdjMaxPlies)
+						{
 							outcome = Outcome::WhiteWin;
+							reason = AdjudicationReason::WinAdjudication;
+						}
 						else if (lossPlies >= WinAdjMaxPlies)
+						{
 							outcome = Outcome::WhiteLoss;
+							reason = AdjudicationReason::WinAdjudication;
+						}
 						else if (drawPlies >= DrawAdjMaxPlies)
+						{
 							outcome = Outcome::Draw;
+							reason = AdjudicationReason::DrawAdjudication;
+						}
 					}
 
 					const bool filtered = thread->pos.isCheck() || thread->pos.isNoisy(move);
 
 					thread->pos.applyMoveUnchecked<true, false>(move, &thread->nnueState);
+					++plies;
 
 					if (thread->pos.isBareKingWin())
 					{
@@ -308,10 +343,14 @@ namespace stormphranj::datagen
 							outcome = Outcome::WhiteLoss;
 							output.push(true, move, -ScoreMate);
 						}
+
+						reason = AdjudicationReason::BareKing;
+						break;
 					}
 					else if (thread->pos.isDrawn(false))
 					{
 						outcome = Outcome::Draw;
+						reason = AdjudicationReason::DrawRule;
 						output.push(true, move, 0);
 						break;
 					}
@@ -327,6 +366,8 @@ namespace stormphranj::datagen
 				const auto positions = output.writeAllWithOutcome(out, *outcome);
 				totalPositions += positions;
 
+				stats.addGame(*outcome, reason, positions, plies);
+
 				if (game == games - 1
 					|| ((game + 1) % ReportInterval) == 0
 					|| s_stop.load(std::memory_order::seq_cst))
@@ -339,14 +380,14 @@ namespace stormphranj::datagen
 			}
 		}
 
-		template auto runThread<Marlinformat>(u32 id,
-			u32 games, u64 seed, const std::filesystem::path &outDir);
-		template auto runThread<ViriBinpack>(u32 id,
-			u32 games, u64 seed, const std::filesystem::path &outDir);
+		template auto runThread<Marlinformat>(u32 id, u32 games, u64 seed,
+			const std::filesystem::path &outDir, const EpdBook *book, u32 randomMoves, ThreadStats &stats);
+		template auto runThread<ViriBinpack>(u32 id, u32 games, u64 seed,
+			const std::filesystem::path &outDir, const EpdBook *book, u32 randomMoves, ThreadStats &stats);
 	}
 
 	auto run(const std::function<void()> &printUsage, const std::string &format,
-		const std::string &output, i32 threads, u32 games) -> i32
+		const std::string &output, i32 threads, u32 games, const Options &options) -> i32
 	{
 		std::function<decltype(runThread<Marlinformat>)> threadFunc{};
 
@@ -366,8 +407,31 @@ namespace stormphranj::datagen
 
 		const std::filesystem::path outDir{output};
 
+		std::optional<EpdBook> book{};
+
+		if (options.book)
+		{
+			book.emplace();
+
+			if (!book->open(*options.book))
+			{
+				std::cerr << "failed to open book " << *options.book << std::endl;
+				return 1;
+			}
+
+			std::cout << "starting games from book " << *options.book << std::endl;
+		}
+
+		const auto randomMoves = options.randomMoves.value_or(book ? DefaultBookRandomMoves : DefaultRandomMoves);
+		std::cout << "playing " << randomMoves << "-" << (randomMoves + 1) << " random moves per game" << std::endl;
+
 		initCtrlCHandler();
 
+		const auto statsFile = outDir / "stats.jsonl";
+		std::cout << "writing stats to " << statsFile << " every " << StatsReportInterval << " sec" << std::endl;
+
+		StatsReporter stats{static_cast<u32>(threads), statsFile, StatsReportInterval};
+
 		std::vector<std::thread> theThreads{};
 		theThreads.reserve(threads);
 
@@ -375,11 +439,14 @@ namespace stormphranj::datagen
 			std::cout << "generating on " << threads << " threads" << std::endl;
 		else std::cout << "generating " << games << " games each on " << threads << " threads" << std::endl;
 
+		stats.start();
+
 		for (u32 i = 0; i < threads; ++i)
 		{
 			theThreads.emplace_back([&, i]()
 			{
-				threadFunc(i, games, baseSeed + i, outDir);
+				threadFunc(i, games, baseSeed + i, outDir,
+					book ? &*book : nullptr, randomMoves, stats.threadStats(i));
 			});
 		}
 
@@ -388,6 +455,11 @@ namespace stormphranj::datagen
 			thread.join();
 		}
 
+		stats.stop();
+
+		if (book && book->invalidLines() > 0)
+			std::cerr << "skipped " << book->invalidLines() << " invalid lines in book " << *options.book << std::endl;
+
 		std::cout << "done" << std::endl;
 
 		return 0;
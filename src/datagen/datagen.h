@@ -23,11 +23,23 @@
 #include <string>
 #include <limits>
 #include <functional>
+#include <optional>
 
 namespace stormphranj::datagen
 {
 	constexpr auto UnlimitedGames = std::numeric_limits<u32>::max();
 
+	// games get either this many or one more random moves before the first search
+	constexpr u32 DefaultRandomMoves = 8;
+	constexpr u32 DefaultBookRandomMoves = 2;
+
+	struct Options
+	{
+		// EPD/FEN file to take start positions from, instead of the startpos
+		std::optional<std::string> book{};
+		std::optional<u32> randomMoves{};
+	};
+
 	auto run(const std::function<void()> &printUsage, const std::string &format,
-		const std::string &output, i32 threads, u32 games = UnlimitedGames) -> i32;
+		const std::string &output, i32 threads, u32 games = UnlimitedGames, const Options &options = {}) -> i32;
 }
@@ -0,0 +1,299 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "datastat.h"
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <cstdlib>
+
+#include "../util/mmap.h"
+#include "../util/timer.h"
+
+namespace stormphranj::datagen
+{
+	namespace
+	{
+		constexpr usize ChunkSize = 16 * 1024 * 1024;
+
+		constexpr i32 ScoreBucketSize = 100;
+		constexpr i32 ScoreBucketLimit = 3000;
+
+		// one bucket per ScoreBucketSize in [-limit, limit), plus one each side for anything beyond
+		constexpr usize ScoreBuckets = 2 * ScoreBucketLimit / ScoreBucketSize + 2;
+
+		constexpr usize GameLengthBucketSize = 25;
+		constexpr usize GameLengthBuckets = 20;
+
+		struct Stats
+		{
+			u64 positions{};
+			u64 games{};
+
+			std::array<u64, 3> outcomes{};
+			std::array<u64, ScoreBuckets> scores{};
+
+			// indexed by piece count
+			std::array<u64, 33> pieceCounts{};
+			// indexed by [color][piece type]
+			std::array<std::array<u64, 6>, 2> pieceTotals{};
+
+			// the last bucket collects everything longer
+			std::array<u64, GameLengthBuckets + 1> gameLengths{};
+
+			std::array<u64, static_cast<usize>(Corruption::Count)> corruption{};
+
+			auto position(const Position &pos, i16 score, Outcome wdl,
+				[[maybe_unused]] Move move) -> void
+			{
+				++positions;
+				++outcomes[static_cast<usize>(wdl)];
+
+				if (score < -ScoreBucketLimit)
+					++scores[0];
+				else if (score >= ScoreBucketLimit)
+					++scores[ScoreBuckets - 1];
+				else ++scores[(score + ScoreBucketLimit) / ScoreBucketSize + 1];
+
+				const auto &bbs = pos.bbs();
+
+				++pieceCounts[bbs.occupancy().popcount()];
+
+				for (const auto color : {Color::Black, Color::White})
+				{
+					for (u32 piece = 0; piece < 6; ++piece)
+					{
+						pieceTotals[static_cast<usize>(color)][piece]
+							+= bbs.forPiece(static_cast<PieceType>(piece), color).popcount();
+					}
+				}
+			}
+
+			auto game(u32 length, [[maybe_unused]] Outcome wdl) -> void
+			{
+				++games;
+				++gameLengths[std::min<usize>(length / GameLengthBucketSize, GameLengthBuckets)];
+			}
+
+			auto corrupt(Corruption type) -> void
+			{
+				++corruption[static_cast<usize>(type)];
+			}
+
+			auto operator+=(const Stats &other) -> Stats &
+			{
+				const auto addAll = [](auto &dst, const auto &src)
+				{
+					for (usize i = 0; i < dst.size(); ++i)
+					{
+						dst[i] += src[i];
+					}
+				};
+
+				positions += other.positions;
+				games += other.games;
+
+				addAll(outcomes, other.outcomes);
+				addAll(scores, other.scores);
+				addAll(pieceCounts, other.pieceCounts);
+				addAll(pieceTotals[0], other.pieceTotals[0]);
+				addAll(pieceTotals[1], other.pieceTotals[1]);
+				addAll(gameLengths, other.gameLengths);
+				addAll(corruption, other.corruption);
+
+				return *this;
+			}
+		};
+
+		auto percent(u64 n, u64 total)
+		{
+			return total == 0 ? 0.0 : static_cast<f64>(n) * 100.0 / static_cast<f64>(total);
+		}
+
+		auto printStats(const Stats &stats, DataFormat format) -> void
+		{
+			std::cout << std::fixed << std::setprecision(2);
+
+			std::cout << "positions: " << stats.positions << std::endl;
+
+			if (format == DataFormat::ViriBinpack)
+			{
+				std::cout << "games: " << stats.games << std::endl;
+				std::cout << "average game length: "
+					<< (stats.games == 0 ? 0.0 : static_cast<f64>(stats.positions) / static_cast<f64>(stats.games))
+					<< std::endl;
+			}
+
+			std::cout << "\nwdl:" << std::endl;
+			std::cout << "  white win:  " << stats.outcomes[2]
+				<< " (" << percent(stats.outcomes[2], stats.positions) << "%)" << std::endl;
+			std::cout << "  draw:       " << stats.outcomes[1]
+				<< " (" << percent(stats.outcomes[1], stats.positions) << "%)" << std::endl;
+			std::cout << "  white loss: " << stats.outcomes[0]
+				<< " (" << percent(stats.outcomes[0], stats.positions) << "%)" << std::endl;
+
+			std::cout << "\nscores:" << std::endl;
+
+			for (usize i = 0; i < ScoreBuckets; ++i)
+			{
+				if (stats.scores[i] == 0)
+					continue;
+
+				if (i == 0)
+					std::cout << "  < " << -ScoreBucketLimit;
+				else if (i == ScoreBuckets - 1)
+					std::cout << "  >= " << ScoreBucketLimit;
+				else
+				{
+					const auto low = static_cast<i32>(i - 1) * ScoreBucketSize - ScoreBucketLimit;
+					std::cout << "  [" << low << ", " << (low + ScoreBucketSize) << ")";
+				}
+
+				std::cout << ": " << stats.scores[i]
+					<< " (" << percent(stats.scores[i], stats.positions) << "%)" << std::endl;
+			}
+
+			std::cout << "\npiece counts:" << std::endl;
+
+			for (usize i = 0; i < stats.pieceCounts.size(); ++i)
+			{
+				if (stats.pieceCounts[i] == 0)
+					continue;
+
+				std::cout << "  " << i << ": " << stats.pieceCounts[i]
+					<< " (" << percent(stats.pieceCounts[i], stats.positions) << "%)" << std::endl;
+			}
+
+			static constexpr std::array PieceNames{"pawns", "alfils", "ferzes", "knights", "rooks", "kings"};
+
+			std::cout << "\naverage material (white/black):" << std::endl;
+
+			for (usize piece = 0; piece < 6; ++piece)
+			{
+				const auto average = [&](Color color)
+				{
+					return stats.positions == 0 ? 0.0
+						: static_cast<f64>(stats.pieceTotals[static_cast<usize>(color)][piece])
+							/ static_cast<f64>(stats.positions);
+				};
+
+				std::cout << "  " << PieceNames[piece] << ": "
+					<< average(Color::White) << " / " << average(Color::Black) << std::endl;
+			}
+
+			if (format == DataFormat::ViriBinpack)
+			{
+				std::cout << "\ngame lengths:" << std::endl;
+
+				for (usize i = 0; i < stats.gameLengths.size(); ++i)
+				{
+					if (stats.gameLengths[i] == 0)
+						continue;
+
+					if (i == GameLengthBuckets)
+						std::cout << "  >= " << (i * GameLengthBucketSize);
+					else std::cout << "  [" << (i * GameLengthBucketSize) << ", " << ((i + 1) * GameLengthBucketSize) << ")";
+
+					std::cout << ": " << stats.gameLengths[i]
+						<< " (" << percent(stats.gameLengths[i], stats.games) << "%)" << std::endl;
+				}
+			}
+
+			static constexpr std::array CorruptionNames{"invalid board", "invalid outcome", "invalid move", "truncated"};
+
+			std::cout << "\ncorrupt records:" << std::endl;
+
+			for (usize i = 0; i < stats.corruption.size(); ++i)
+			{
+				std::cout << "  " << CorruptionNames[i] << ": " << stats.corruption[i] << std::endl;
+			}
+
+			std::cout << std::defaultfloat;
+		}
+	}
+
+	auto runDatastat(DataFormat format, const std::vector<std::string> &inputs, u32 threads) -> i32
+	{
+		std::vector<util::MappedFile> files(inputs.size());
+		std::vector<std::span<const std::byte>> chunks{};
+
+		usize totalBytes{};
+
+		for (usize i = 0; i < inputs.size(); ++i)
+		{
+			if (!files[i].open(inputs[i], util::AccessPattern::Sequential))
+				return 1;
+
+			totalBytes += files[i].size();
+
+			const auto fileChunks = splitChunks(format, files[i].data(), ChunkSize);
+			chunks.insert(chunks.end(), fileChunks.begin(), fileChunks.end());
+		}
+
+		std::cout << "reading " << inputs.size() << " files (" << chunks.size()
+			<< " chunks) on " << threads << " threads" << std::endl;
+
+		const auto startTime = util::g_timer.time();
+
+		Stats total{};
+		std::mutex totalMutex{};
+
+		std::atomic<usize> nextChunk{0};
+
+		std::vector<std::thread> theThreads{};
+		theThreads.reserve(threads);
+
+		for (u32 i = 0; i < threads; ++i)
+		{
+			theThreads.emplace_back([&]()
+			{
+				Position pos{};
+				Stats stats{};
+
+				usize chunk;
+				while ((chunk = nextChunk.fetch_add(1, std::memory_order::relaxed)) < chunks.size())
+				{
+					readChunk(format, chunks[chunk], pos, stats);
+				}
+
+				const std::scoped_lock lock{totalMutex};
+				total += stats;
+			});
+		}
+
+		for (auto &thread : theThreads)
+		{
+			thread.join();
+		}
+
+		const auto time = util::g_timer.time() - startTime;
+
+		std::cout << "read " << (static_cast<f64>(totalBytes) / (1024.0 * 1024.0)) << " MiB in " << time << " sec ("
+			<< (static_cast<f64>(total.positions) / time) << " positions/sec, "
+			<< (static_cast<f64>(totalBytes) / (1024.0 * 1024.0) / time) << " MiB/sec)\n" << std::endl;
+
+		printStats(total, format);
+
+		return 0;
+	}
+}
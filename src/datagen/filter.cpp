@@ -0,0 +1,325 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "filter.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <array>
+#include <cstdlib>
+
+#include "marlinformat.h"
+#include "../util/mmap.h"
+#include "../util/timer.h"
+
+namespace stormphranj::datagen
+{
+	namespace
+	{
+		constexpr usize ChunkSize = 16 * 1024 * 1024;
+		constexpr usize ShardBufferSize = 65536;
+
+		// Blocked bloom filter, every key only touches a single cache line
+		class BloomFilter
+		{
+		public:
+			explicit BloomFilter(usize mb)
+				: m_blockCount{std::max<usize>(mb * 1024 * 1024 / sizeof(Block), 1)},
+				  m_blocks{std::make_unique<Block[]>(m_blockCount)} {}
+
+			// Returns true if the key was (probably) already present
+			[[nodiscard]] auto testAndSet(u64 key) -> bool
+			{
+				static constexpr u32 Hashes = 6;
+				static constexpr u32 BitsPerHash = 9;
+
+				auto &block = m_blocks[static_cast<u64>((static_cast<u128>(key) * m_blockCount) >> 64)];
+
+				// the block index consumes the high bits, scramble the rest back into them
+				const auto hash = key * U64(0x9E3779B97F4A7C15);
+
+				bool present = true;
+
+				for (u32 i = 0; i < Hashes; ++i)
+				{
+					const auto bit = (hash >> (64 - BitsPerHash * (i + 1))) & (BlockBits - 1);
+					const auto mask = U64(1) << (bit % 64);
+
+					auto &word = block.words[bit / 64];
+
+					// avoid dirtying the line if the bit is already set
+					if (word.load(std::memory_order::relaxed) & mask)
+						continue;
+
+					present &= (word.fetch_or(mask, std::memory_order::relaxed) & mask) != 0;
+				}
+
+				return present;
+			}
+
+		private:
+			static constexpr usize BlockBits = 512;
+
+			struct alignas(SPJ_CACHE_LINE_SIZE) Block
+			{
+				std::array<std::atomic<u64>, BlockBits / 64> words{};
+			};
+
+			usize m_blockCount;
+			std::unique_ptr<Block[]> m_blocks;
+		};
+
+		class ShardWriter
+		{
+		public:
+			explicit ShardWriter(const std::filesystem::path &path)
+				: m_stream{path, std::ios::binary | std::ios::trunc} {}
+
+			[[nodiscard]] inline auto ok() const
+			{
+				return static_cast<bool>(m_stream);
+			}
+
+			auto write(const std::vector<marlinformat::PackedBoard> &boards) -> void
+			{
+				const std::scoped_lock lock{m_mutex};
+
+				m_stream.write(reinterpret_cast<const char *>(boards.data()),
+					static_cast<std::streamsize>(boards.size() * sizeof(marlinformat::PackedBoard)));
+			}
+
+		private:
+			std::mutex m_mutex{};
+			std::ofstream m_stream;
+		};
+
+		struct Counters
+		{
+			std::atomic<u64> read{};
+			std::atomic<u64> kept{};
+			std::atomic<u64> filtered{};
+			std::atomic<u64> duplicates{};
+			std::atomic<u64> corrupt{};
+		};
+
+		class FilterVisitor
+		{
+		public:
+			FilterVisitor(const FilterOptions &options, BloomFilter *bloom,
+				std::vector<std::unique_ptr<ShardWriter>> &shards)
+				: m_options{options},
+				  m_bloom{bloom},
+				  m_shards{shards},
+				  m_buffers(shards.size())
+			{
+				for (auto &buffer : m_buffers)
+				{
+					buffer.reserve(ShardBufferSize);
+				}
+			}
+
+			auto position(const Position &pos, i16 score, Outcome wdl, Move move) -> void
+			{
+				++m_read;
+
+				const auto ply = pos.plyFromStartpos();
+				const auto absScore = static_cast<u32>(std::abs(static_cast<i32>(score)));
+				const auto pieces = static_cast<u32>(pos.bbs().occupancy().popcount());
+
+				// same criteria as datagen's own filtering, which viri binpack does not record
+				if (pos.isCheck() || (move && pos.isNoisy(move))
+					|| ply < m_options.minPly || ply > m_options.maxPly
+					|| absScore < m_options.minScore || absScore > m_options.maxScore
+					|| pieces < m_options.minPieces || pieces > m_options.maxPieces)
+				{
+					++m_filtered;
+					return;
+				}
+
+				if (m_bloom && m_bloom->testAndSet(pos.key()))
+				{
+					++m_duplicates;
+					return;
+				}
+
+				++m_kept;
+
+				auto board = marlinformat::PackedBoard::pack(pos, score);
+				board.wdl = wdl;
+
+				const auto shard = pos.key() % m_buffers.size();
+				auto &buffer = m_buffers[shard];
+
+				buffer.push_back(board);
+
+				if (buffer.size() >= ShardBufferSize)
+				{
+					m_shards[shard]->write(buffer);
+					buffer.clear();
+				}
+			}
+
+			auto game([[maybe_unused]] u32 positions, [[maybe_unused]] Outcome wdl) -> void {}
+
+			auto corrupt([[maybe_unused]] Corruption corruption) -> void
+			{
+				++m_corrupt;
+			}
+
+			auto finish(Counters &counters) -> void
+			{
+				for (usize shard = 0; shard < m_buffers.size(); ++shard)
+				{
+					if (!m_buffers[shard].empty())
+					{
+						m_shards[shard]->write(m_buffers[shard]);
+						m_buffers[shard].clear();
+					}
+				}
+
+				counters.read.fetch_add(m_read, std::memory_order::relaxed);
+				counters.kept.fetch_add(m_kept, std::memory_order::relaxed);
+				counters.filtered.fetch_add(m_filtered, std::memory_order::relaxed);
+				counters.duplicates.fetch_add(m_duplicates, std::memory_order::relaxed);
+				counters.corrupt.fetch_add(m_corrupt, std::memory_order::relaxed);
+
+				m_read = m_kept = m_filtered = m_duplicates = m_corrupt = 0;
+			}
+
+		private:
+			const FilterOptions &m_options;
+			BloomFilter *m_bloom;
+
+			std::vector<std::unique_ptr<ShardWriter>> &m_shards;
+			std::vector<std::vector<marlinformat::PackedBoard>> m_buffers;
+
+			u64 m_read{};
+			u64 m_kept{};
+			u64 m_filtered{};
+			u64 m_duplicates{};
+			u64 m_corrupt{};
+		};
+	}
+
+	auto runFilter(DataFormat format, const std::vector<std::string> &inputs,
+		const std::string &outDir, const FilterOptions &options) -> i32
+	{
+		std::vector<util::MappedFile> files(inputs.size());
+		std::vector<std::span<const std::byte>> chunks{};
+
+		usize totalBytes{};
+
+		for (usize i = 0; i < inputs.size(); ++i)
+		{
+			if (!files[i].open(inputs[i], util::AccessPattern::Sequential))
+				return 1;
+
+			totalBytes += files[i].size();
+
+			const auto fileChunks = splitChunks(format, files[i].data(), ChunkSize);
+			chunks.insert(chunks.end(), fileChunks.begin(), fileChunks.end());
+		}
+
+		std::error_code error{};
+		std::filesystem::create_directories(outDir, error);
+
+		if (error)
+		{
+			std::cerr << "failed to create output directory " << outDir << ": " << error.message() << std::endl;
+			return 1;
+		}
+
+		// shards left over from an earlier run would bring back the duplicates
+		// removed here, or could be one of the inputs being read
+		if (!std::filesystem::is_empty(outDir, error) || error)
+		{
+			std::cerr << "output directory " << outDir << " is not empty" << std::endl;
+			return 1;
+		}
+
+		std::vector<std::unique_ptr<ShardWriter>> shards{};
+		shards.reserve(options.shards);
+
+		for (u32 i = 0; i < options.shards; ++i)
+		{
+			const auto path = std::filesystem::path{outDir} / (std::to_string(i) + "." + Marlinformat::Extension);
+			auto &shard = shards.emplace_back(std::make_unique<ShardWriter>(path));
+
+			if (!shard->ok())
+			{
+				std::cerr << "failed to open output file " << path << std::endl;
+				return 1;
+			}
+		}
+
+		std::unique_ptr<BloomFilter> bloom{};
+
+		if (options.dedupMb > 0)
+			bloom = std::make_unique<BloomFilter>(options.dedupMb);
+
+		std::cout << "filtering " << inputs.size() << " files (" << chunks.size() << " chunks) on "
+			<< options.threads << " threads into " << options.shards << " shards" << std::endl;
+
+		const auto startTime = util::g_timer.time();
+
+		Counters counters{};
+		std::atomic<usize> nextChunk{0};
+
+		std::vector<std::thread> threads{};
+		threads.reserve(options.threads);
+
+		for (u32 i = 0; i < options.threads; ++i)
+		{
+			threads.emplace_back([&]()
+			{
+				Position pos{};
+				FilterVisitor visitor{options, bloom.get(), shards};
+
+				usize chunk;
+				while ((chunk = nextChunk.fetch_add(1, std::memory_order::relaxed)) < chunks.size())
+				{
+					readChunk(format, chunks[chunk], pos, visitor);
+				}
+
+				visitor.finish(counters);
+			});
+		}
+
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		const auto time = util::g_timer.time() - startTime;
+		const auto read = counters.read.load();
+
+		std::cout << "read " << read << " positions (" << (static_cast<f64>(totalBytes) / (1024.0 * 1024.0))
+			<< " MiB) in " << time << " sec (" << (static_cast<f64>(read) / time) << " positions/sec, "
+			<< (static_cast<f64>(totalBytes) / (1024.0 * 1024.0) / time) << " MiB/sec)" << std::endl;
+		std::cout << "kept " << counters.kept.load() << ", filtered " << counters.filtered.load()
+			<< ", duplicates " << counters.duplicates.load()
+			<< ", corrupt records " << counters.corrupt.load() << std::endl;
+
+		return 0;
+	}
+}
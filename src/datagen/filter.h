@@ -0,0 +1,54 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <string>
+#include <vector>
+#include <limits>
+
+#include "reader.h"
+
+namespace stormphranj::datagen
+{
+	struct FilterOptions
+	{
+		u32 threads{1};
+		u32 shards{1};
+
+		// size of the bloom filter used to remove duplicates, 0 to disable deduplication
+		u32 dedupMb{512};
+
+		u32 minPly{0};
+		u32 maxPly{std::numeric_limits<u32>::max()};
+
+		// absolute white-relative score
+		u32 minScore{0};
+		u32 maxScore{std::numeric_limits<u32>::max()};
+
+		u32 minPieces{0};
+		u32 maxPieces{32};
+	};
+
+	// Reads positions from datagen output and writes the ones that survive
+	// filtering and deduplication to marlinformat shards in outDir
+	auto runFilter(DataFormat format, const std::vector<std::string> &inputs,
+		const std::string &outDir, const FilterOptions &options) -> i32;
+}
@@ -74,6 +74,43 @@ namespace stormphranj::datagen
 
 				return board;
 			}
+
+			// Returns false if this is not a valid packed board.
+			// Does not touch the eval or wdl
+			[[nodiscard]] auto unpack(Position &pos) const -> bool
+			{
+				auto occ = Bitboard{occupancy};
+
+				if (occ.popcount() > 32)
+					return false;
+
+				BitboardSet bbs{};
+
+				usize i = 0;
+				while (occ)
+				{
+					const auto square = occ.popLowestSquare();
+					const auto pieceId = static_cast<u8>(pieces[i++] & 0xF);
+
+					// 6 is marlinformat's unmoved rook, which shatranj has no use for
+					if ((pieceId & 0x7) >= 6)
+						return false;
+
+					const auto mask = Bitboard::fromSquare(square);
+
+					bbs.forPiece(static_cast<PieceType>(pieceId & 0x7)) |= mask;
+					bbs.forColor((pieceId & (1 << 3)) ? Color::Black : Color::White) |= mask;
+				}
+
+				// no en passant in shatranj, but accept marlinformat's usual "none" value
+				if (const auto epSquare = stmEpSquare & 0x7F;
+					epSquare != 0 && epSquare != 64)
+					return false;
+
+				const auto stm = (stmEpSquare & (1 << 7)) ? Color::Black : Color::White;
+
+				return pos.resetFromBbs(bbs, stm, halfmoveClock, fullmoveNumber);
+			}
 		};
 	}
 
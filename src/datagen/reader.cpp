@@ -0,0 +1,60 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "reader.h"
+
+#include <algorithm>
+
+namespace stormphranj::datagen
+{
+	auto parseDataFormat(const std::string &name) -> std::optional<DataFormat>
+	{
+		if (name == "marlinformat")
+			return DataFormat::Marlinformat;
+		else if (name == "viri_binpack")
+			return DataFormat::ViriBinpack;
+
+		return {};
+	}
+
+	auto splitChunks(DataFormat format, std::span<const std::byte> data,
+		usize targetSize) -> std::vector<std::span<const std::byte>>
+	{
+		std::vector<std::span<const std::byte>> chunks{};
+
+		if (data.empty())
+			return chunks;
+
+		if (format == DataFormat::ViriBinpack)
+		{
+			chunks.push_back(data);
+			return chunks;
+		}
+
+		static constexpr auto RecordSize = sizeof(marlinformat::PackedBoard);
+
+		targetSize = std::max(targetSize - targetSize % RecordSize, RecordSize);
+
+		for (usize offset = 0; offset < data.size(); offset += targetSize)
+		{
+			chunks.push_back(data.subspan(offset, std::min(targetSize, data.size() - offset)));
+		}
+
+		return chunks;
+	}
+}
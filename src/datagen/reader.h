@@ -0,0 +1,210 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <span>
+#include <vector>
+#include <string>
+#include <optional>
+#include <cstring>
+#include <cstddef>
+
+#include "common.h"
+#include "marlinformat.h"
+#include "../position/position.h"
+#include "../move.h"
+
+namespace stormphranj::datagen
+{
+	enum class DataFormat
+	{
+		Marlinformat = 0,
+		ViriBinpack
+	};
+
+	[[nodiscard]] auto parseDataFormat(const std::string &name) -> std::optional<DataFormat>;
+
+	enum class Corruption : u8
+	{
+		InvalidBoard = 0,
+		InvalidOutcome,
+		InvalidMove,
+		Truncated,
+		Count
+	};
+
+	// Splits a file into chunks of roughly targetSize bytes that start and end on record boundaries.
+	// Viri binpack games are variable length, so their boundaries cannot be found without reading
+	// everything before them - those files are returned as a single chunk
+	[[nodiscard]] auto splitChunks(DataFormat format, std::span<const std::byte> data,
+		usize targetSize) -> std::vector<std::span<const std::byte>>;
+
+	// Visitor requirements:
+	//  - visitor.position(const Position &pos, i16 score, Outcome wdl, Move move)
+	//    called for every position. move is the move played from it, or null for marlinformat
+	//  - visitor.game(u32 positions, Outcome wdl)
+	//    called after every complete viri binpack game
+	//  - visitor.corrupt(Corruption corruption)
+	//    called for every record that cannot be read. Corrupt viri binpack games are
+	//    skipped up to the next terminator, after visiting any positions before the corruption
+	// Moves are applied without nnue updates or state history
+	template <typename Visitor>
+	auto readChunk(DataFormat format, std::span<const std::byte> chunk, Position &pos, Visitor &visitor) -> void
+	{
+		using marlinformat::PackedBoard;
+
+		const auto readBoard = [&](usize offset)
+		{
+			PackedBoard board;
+			std::memcpy(&board, chunk.data() + offset, sizeof(PackedBoard));
+			return board;
+		};
+
+		if (format == DataFormat::Marlinformat)
+		{
+			for (usize offset = 0; offset + sizeof(PackedBoard) <= chunk.size(); offset += sizeof(PackedBoard))
+			{
+				const auto board = readBoard(offset);
+
+				if (static_cast<u8>(board.wdl) > static_cast<u8>(Outcome::WhiteWin))
+					visitor.corrupt(Corruption::InvalidOutcome);
+				else if (!board.unpack(pos))
+					visitor.corrupt(Corruption::InvalidBoard);
+				else visitor.position(pos, board.eval, board.wdl, NullMove);
+			}
+
+			if (chunk.size() % sizeof(PackedBoard) != 0)
+				visitor.corrupt(Corruption::Truncated);
+
+			return;
+		}
+
+		static constexpr usize EntrySize = sizeof(u16) + sizeof(i16);
+
+		const auto readEntry = [&](usize offset)
+		{
+			u16 move;
+			i16 score;
+
+			std::memcpy(&move, chunk.data() + offset, sizeof(u16));
+			std::memcpy(&score, chunk.data() + offset + sizeof(u16), sizeof(i16));
+
+			return std::pair{move, score};
+		};
+
+		// returns the offset after the next terminator, or the end of the chunk
+		const auto skipGame = [&](usize offset)
+		{
+			for (; offset + EntrySize <= chunk.size(); offset += EntrySize)
+			{
+				if (readEntry(offset) == std::pair<u16, i16>{0, 0})
+					return offset + EntrySize;
+			}
+
+			return chunk.size();
+		};
+
+		usize offset = 0;
+
+		while (offset < chunk.size())
+		{
+			if (offset + sizeof(PackedBoard) > chunk.size())
+			{
+				visitor.corrupt(Corruption::Truncated);
+				return;
+			}
+
+			const auto board = readBoard(offset);
+			offset += sizeof(PackedBoard);
+
+			if (static_cast<u8>(board.wdl) > static_cast<u8>(Outcome::WhiteWin))
+			{
+				visitor.corrupt(Corruption::InvalidOutcome);
+				offset = skipGame(offset);
+				continue;
+			}
+
+			if (!board.unpack(pos))
+			{
+				visitor.corrupt(Corruption::InvalidBoard);
+				offset = skipGame(offset);
+				continue;
+			}
+
+			u32 positions{};
+
+			bool ended = false;
+			bool corrupt = false;
+
+			while (offset + EntrySize <= chunk.size())
+			{
+				const auto [viriMove, score] = readEntry(offset);
+				offset += EntrySize;
+
+				if (viriMove == 0)
+				{
+					// a null move with a score is written for the final, mated position
+					if (score != 0)
+						continue;
+
+					ended = true;
+					break;
+				}
+
+				const auto src = static_cast<Square>(viriMove & 0x3F);
+				const auto dst = static_cast<Square>((viriMove >> 6) & 0x3F);
+
+				Move move{};
+
+				switch (viriMove >> 14)
+				{
+				case 0: move = Move::standard(src, dst); break;
+				case 3: move = Move::promotion(src, dst); break;
+				default: break;
+				}
+
+				if (!move || !pos.isPseudolegal(move) || !pos.isLegal(move))
+				{
+					visitor.corrupt(Corruption::InvalidMove);
+					offset = skipGame(offset);
+					corrupt = true;
+					break;
+				}
+
+				visitor.position(pos, score, board.wdl, move);
+				++positions;
+
+				pos.applyMoveUnchecked<false, false>(move, nullptr);
+			}
+
+			if (corrupt)
+				continue;
+
+			if (!ended)
+			{
+				visitor.corrupt(Corruption::Truncated);
+				return;
+			}
+
+			visitor.game(positions, board.wdl);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+
+#include <iostream>
+#include <chrono>
+
+#include "../util/timer.h"
+
+namespace stormphranj::datagen
+{
+	namespace
+	{
+		inline auto rate(u64 count, f64 time)
+		{
+			return time > 0.0 ? static_cast<f64>(count) / time : 0.0;
+		}
+	}
+
+	StatsReporter::StatsReporter(u32 threads, const std::filesystem::path &path, f64 interval)
+		: m_threads{threads},
+		  m_threadStats{std::make_unique<ThreadStats[]>(threads)},
+		  m_out{path, std::ios::app},
+		  m_interval{interval}
+	{
+		if (!m_out)
+			std::cerr << "failed to open stats file " << path << std::endl;
+	}
+
+	StatsReporter::~StatsReporter()
+	{
+		stop();
+	}
+
+	auto StatsReporter::start() -> void
+	{
+		m_startTime = util::g_timer.time();
+		m_lastTime = m_startTime;
+
+		m_thread = std::thread{[this]
+		{
+			run();
+		}};
+	}
+
+	auto StatsReporter::stop() -> void
+	{
+		if (!m_thread.joinable())
+			return;
+
+		{
+			std::unique_lock lock{m_stopMutex};
+			m_stop = true;
+		}
+
+		m_stopSignal.notify_all();
+		m_thread.join();
+
+		// final report, covering everything since the last periodic one
+		report();
+	}
+
+	auto StatsReporter::sum() const -> Totals
+	{
+		Totals totals{};
+
+		for (u32 i = 0; i < m_threads; ++i)
+		{
+			const auto &stats = m_threadStats[i];
+
+			totals.games += stats.games.load(std::memory_order::relaxed);
+			totals.positions += stats.positions.load(std::memory_order::relaxed);
+			totals.plies += stats.plies.load(std::memory_order::relaxed);
+			totals.nodes += stats.nodes.load(std::memory_order::relaxed);
+			totals.verificationRejections += stats.verificationRejections.load(std::memory_order::relaxed);
+
+			for (usize j = 0; j < totals.outcomes.size(); ++j)
+			{
+				totals.outcomes[j] += stats.outcomes[j].load(std::memory_order::relaxed);
+			}
+
+			for (usize j = 0; j < totals.reasons.size(); ++j)
+			{
+				totals.reasons[j] += stats.reasons[j].load(std::memory_order::relaxed);
+			}
+		}
+
+		return totals;
+	}
+
+	auto StatsReporter::report() -> void
+	{
+		if (!m_out)
+			return;
+
+		const auto now = util::g_timer.time();
+		const auto totals = sum();
+
+		const auto elapsed = now - m_startTime;
+		const auto delta = now - m_lastTime;
+
+		const auto reason = [&](AdjudicationReason r)
+		{
+			return totals.reasons[static_cast<usize>(r)];
+		};
+
+		const auto outcome = [&](Outcome o)
+		{
+			return totals.outcomes[static_cast<usize>(o)];
+		};
+
+		m_out << "{\"time\":" << elapsed
+			<< ",\"threads\":" << m_threads
+			<< ",\"games\":" << totals.games
+			<< ",\"positions\":" << totals.positions
+			<< ",\"nodes\":" << totals.nodes
+			<< ",\"games_per_sec\":" << rate(totals.games - m_last.games, delta)
+			<< ",\"positions_per_sec\":" << rate(totals.positions - m_last.positions, delta)
+			<< ",\"nodes_per_sec\":" << rate(totals.nodes - m_last.nodes, delta)
+			<< ",\"total_positions_per_sec\":" << rate(totals.positions, elapsed)
+			<< ",\"avg_game_length\":"
+				<< (totals.games > 0 ? static_cast<f64>(totals.plies) / static_cast<f64>(totals.games) : 0.0)
+			<< ",\"outcomes\":{"
+				<< "\"white_win\":" << outcome(Outcome::WhiteWin)
+				<< ",\"draw\":" << outcome(Outcome::Draw)
+				<< ",\"white_loss\":" << outcome(Outcome::WhiteLoss)
+			<< "},\"adjudication\":{"
+				<< "\"mate\":" << reason(AdjudicationReason::Mate)
+				<< ",\"bare_king\":" << reason(AdjudicationReason::BareKing)
+				<< ",\"win_adj\":" << reason(AdjudicationReason::WinAdjudication)
+				<< ",\"draw_adj\":" << reason(AdjudicationReason::DrawAdjudication)
+				<< ",\"draw_rule\":" << reason(AdjudicationReason::DrawRule)
+			<< "},\"verification_rejections\":" << totals.verificationRejections
+			<< "}" << std::endl;
+
+		m_lastTime = now;
+		m_last = totals;
+	}
+
+	auto StatsReporter::run() -> void
+	{
+		const auto interval = std::chrono::duration<f64>{m_interval};
+
+		std::unique_lock lock{m_stopMutex};
+
+		while (!m_stopSignal.wait_for(lock, interval, [this] { return m_stop; }))
+		{
+			report();
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+
+#include "../arch.h"
+#include "common.h"
+
+namespace stormphranj::datagen
+{
+	enum class AdjudicationReason : u8
+	{
+		// no legal moves, or the search found a forced mate
+		Mate = 0,
+		BareKing,
+		WinAdjudication,
+		DrawAdjudication,
+		// repetition, 70 move rule or bare kings
+		DrawRule,
+		Count
+	};
+
+	constexpr auto AdjudicationReasonCount = static_cast<usize>(AdjudicationReason::Count);
+
+	// Each datagen thread owns one of these, and is the only thread that ever writes to it.
+	// The reporter thread only reads, so increments do not need to be locked
+	struct alignas(SPJ_CACHE_LINE_SIZE) ThreadStats
+	{
+		std::atomic<u64> games{};
+		std::atomic<u64> positions{};
+		std::atomic<u64> plies{};
+		std::atomic<u64> nodes{};
+		std::atomic<u64> verificationRejections{};
+
+		std::array<std::atomic<u64>, 3> outcomes{};
+		std::array<std::atomic<u64>, AdjudicationReasonCount> reasons{};
+
+		static inline auto add(std::atomic<u64> &counter, u64 v)
+		{
+			counter.store(counter.load(std::memory_order::relaxed) + v, std::memory_order::relaxed);
+		}
+
+		inline auto addGame(Outcome outcome, AdjudicationReason reason, u64 gamePositions, u64 gamePlies)
+		{
+			add(games, 1);
+			add(positions, gamePositions);
+			add(plies, gamePlies);
+
+			add(outcomes[static_cast<usize>(outcome)], 1);
+			add(reasons[static_cast<usize>(reason)], 1);
+		}
+	};
+
+	// Periodically sums the stats of all datagen threads and
+	// appends them as a JSON object to a file, one line per report
+	class StatsReporter
+	{
+	public:
+		StatsReporter(u32 threads, const std::filesystem::path &path, f64 interval);
+		~StatsReporter();
+
+		[[nodiscard]] inline auto threadStats(u32 id) -> ThreadStats &
+		{
+			return m_threadStats[id];
+		}
+
+		auto start() -> void;
+		auto stop() -> void;
+
+	private:
+		struct Totals
+		{
+			u64 games{};
+			u64 positions{};
+			u64 plies{};
+			u64 nodes{};
+			u64 verificationRejections{};
+
+			std::array<u64, 3> outcomes{};
+			std::array<u64, AdjudicationReasonCount> reasons{};
+		};
+
+		[[nodiscard]] auto sum() const -> Totals;
+		auto report() -> void;
+
+		auto run() -> void;
+
+		u32 m_threads;
+		std::unique_ptr<ThreadStats[]> m_threadStats;
+
+		std::ofstream m_out;
+		f64 m_interval;
+
+		f64 m_startTime{};
+
+		f64 m_lastTime{};
+		Totals m_last{};
+
+		std::thread m_thread{};
+
+		std::mutex m_stopMutex{};
+		std::condition_variable m_stopSignal{};
+		bool m_stop{false};
+	};
+}
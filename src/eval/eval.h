@@ -48,12 +48,17 @@ namespace stormphranj::eval
 		return std::clamp(eval, -ScoreWin + 1, ScoreWin - 1);
 	}
 
+	// unadjusted network output, suitable for caching
+	inline auto rawEval(const Position &pos, const NnueState &nnueState)
+	{
+		return nnueState.evaluate(pos.bbs(), pos.toMove());
+	}
+
 	template <bool Scale = true>
 	inline auto staticEval(const Position &pos,
 		[[maybe_unused]] const NnueState &nnueState, const Contempt &contempt = {})
 	{
-		const auto nnueEval = nnueState.evaluate(pos.bbs(), pos.toMove());
-		return adjustEval<Scale>(pos, contempt, nnueEval);
+		return adjustEval<Scale>(pos, contempt, rawEval(pos, nnueState));
 	}
 
 	template <bool Scale = true>
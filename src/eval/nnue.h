@@ -28,6 +28,7 @@
 #include "nnue/layers.h"
 #include "nnue/activation.h"
 #include "../util/static_vector.h"
+#include "../profile.h"
 
 namespace stormphranj::eval
 {
@@ -121,6 +122,8 @@ namespace stormphranj::eval
 		template <bool Push>
 		inline auto update(const NnueUpdates &updates, const BitboardSet &bbs, Square blackKing, Square whiteKing)
 		{
+			SPJ_PROFILE_SCOPE(NnueUpdate);
+
 			assert(m_curr >= &m_accumulatorStack[0] && m_curr <= &m_accumulatorStack.back());
 			assert(!updates.refresh[0] || !updates.refresh[1]);
 
@@ -177,6 +180,8 @@ namespace stormphranj::eval
 
 		[[nodiscard]] inline auto evaluate(const BitboardSet &bbs, Color stm) const
 		{
+			SPJ_PROFILE_SCOPE(Evaluate);
+
 			assert(m_curr >= &m_accumulatorStack[0] && m_curr <= &m_accumulatorStack.back());
 			assert(stm != Color::None);
 
@@ -24,6 +24,7 @@
 #include <utility>
 #include <cstring>
 
+#include "arch.h"
 #include "core.h"
 #include "move.h"
 #include "position/position.h"
@@ -94,49 +95,72 @@ namespace stormphranj
 			return m_table[static_cast<i32>(move.moving)][static_cast<i32>(move.dst)];
 		}
 
+		// rows for the pieces of one side are interleaved with the other's,
+		// so all of them are touched when scoring a node's quiet moves
+		inline auto prefetch(Color color) const
+		{
+			for (i32 piece = static_cast<i32>(color); piece < 12; piece += 2)
+			{
+				const auto *row = reinterpret_cast<const char *>(m_table[piece].data());
+
+				for (usize offset = 0; offset < sizeof(m_table[piece]); offset += SPJ_CACHE_LINE_SIZE)
+				{
+					__builtin_prefetch(row + offset);
+				}
+			}
+		}
+
 	private:
 		using Table = std::array<std::array<HistoryScore, 64>, 12>;
 
 		Table m_table{};
 	};
 
+	// continuation entries for the moves made 1, 2 and 4 plies ago (null if
+	// there was no such move), looked up once per node from the search stack
+	using ContinuationEntries = std::array<ContinuationEntry *, 3>;
+
 	class HistoryTable
 	{
 	public:
 		HistoryTable() = default;
 		~HistoryTable() = default;
 
-		inline auto updateCountermove(i32 ply, std::span<const HistoryMove> prevMoves, Move countermove)
+		inline auto updateCountermove(HistoryMove prevMove, Move countermove)
 		{
-			if (ply > 0 && prevMoves[ply - 1])
-				countermoveEntry(prevMoves[ply - 1]) = countermove;
+			if (prevMove)
+				countermoveEntry(prevMove) = countermove;
 		}
 
-		[[nodiscard]] inline auto countermove(i32 ply, std::span<const HistoryMove> prevMoves) const
+		[[nodiscard]] inline auto countermove(HistoryMove prevMove) const
 		{
-			if (ply > 0 && prevMoves[ply - 1])
-				return countermoveEntry(prevMoves[ply - 1]);
+			if (prevMove)
+				return countermoveEntry(prevMove);
 			else return NullMove;
 		}
 
 		inline auto updateQuietScore(HistoryMove move, Bitboard threats,
-			i32 ply, std::span<const HistoryMove> prevMoves, HistoryScore adjustment)
+			const ContinuationEntries &continuations, HistoryScore adjustment)
 		{
 			updateMainScore(move, threats[move.src], threats[move.dst], adjustment);
 
-			updateContinuationScore(move, ply, prevMoves, 1, adjustment);
-			updateContinuationScore(move, ply, prevMoves, 2, adjustment);
-			updateContinuationScore(move, ply, prevMoves, 4, adjustment);
+			for (auto *entry : continuations)
+			{
+				if (entry)
+					updateHistoryScore(entry->score(move), adjustment);
+			}
 		}
 
 		[[nodiscard]] inline auto quietScore(HistoryMove move, Bitboard threats,
-			i32 ply, std::span<const HistoryMove> prevMoves) const
+			const ContinuationEntries &continuations) const
 		{
 			auto history = mainScore(move, threats[move.src], threats[move.dst]);
 
-			history += continuationScore(move, ply, prevMoves, 1);
-			history += continuationScore(move, ply, prevMoves, 2);
-			history += continuationScore(move, ply, prevMoves, 4);
+			for (const auto *entry : continuations)
+			{
+				if (entry)
+					history += entry->score(move);
+			}
 
 			return history;
 		}
@@ -151,6 +175,11 @@ namespace stormphranj
 			return noisyEntry(move, captured, threats[move.dst]);
 		}
 
+		[[nodiscard]] inline auto contEntry(HistoryMove move) -> ContinuationEntry &
+		{
+			return m_continuationTable[static_cast<i32>(move.moving)][static_cast<i32>(move.dst)];
+		}
+
 		inline auto clear()
 		{
 			std::memset(m_table.data(), 0, sizeof(Table));
@@ -200,16 +229,6 @@ namespace stormphranj
 				[static_cast<i32>(move.moving)][static_cast<i32>(move.dst)][defended];
 		}
 
-		[[nodiscard]] inline auto contEntry(HistoryMove move) -> auto &
-		{
-			return m_continuationTable[static_cast<i32>(move.moving)][static_cast<i32>(move.dst)];
-		}
-
-		[[nodiscard]] inline auto contEntry(HistoryMove move) const -> const auto &
-		{
-			return m_continuationTable[static_cast<i32>(move.moving)][static_cast<i32>(move.dst)];
-		}
-
 		[[nodiscard]] inline auto mainScore(HistoryMove move, bool srcThreat, bool dstThreat) const -> i32
 		{
 			return entry(move, srcThreat, dstThreat);
@@ -220,21 +239,6 @@ namespace stormphranj
 			updateHistoryScore(entry(move, srcThreat, dstThreat), adjustment);
 		}
 
-		[[nodiscard]] inline auto continuationScore(HistoryMove move,
-			i32 ply, std::span<const HistoryMove> prevMoves, i32 pliesAgo) const -> i32
-		{
-			if (ply >= pliesAgo && prevMoves[ply - pliesAgo])
-				return contEntry(prevMoves[ply - pliesAgo]).score(move);
-			else return 0;
-		}
-
-		inline auto updateContinuationScore(HistoryMove move,
-			i32 ply, std::span<const HistoryMove> prevMoves, i32 pliesAgo, HistoryScore adjustment) -> void
-		{
-			if (ply >= pliesAgo && prevMoves[ply - pliesAgo])
-				updateHistoryScore(contEntry(prevMoves[ply - pliesAgo]).score(move), adjustment);
-		}
-
 		Table m_table{};
 		CountermoveTable m_countermoveTable{};
 		CaptureTable m_captureTable{};
@@ -57,7 +57,7 @@ namespace stormphranj::keys
 		return keys;
 	}();
 
-	inline auto pieceSquare(Piece piece, Square square) -> u64
+	constexpr auto pieceSquare(Piece piece, Square square) -> u64
 	{
 		if (piece == Piece::None || square == Square::None)
 			return 0;
@@ -66,12 +66,12 @@ namespace stormphranj::keys
 	}
 
 	// for flipping
-	inline auto color()
+	constexpr auto color()
 	{
 		return Keys[offsets::Color];
 	}
 
-	inline auto color(Color c)
+	constexpr auto color(Color c)
 	{
 		return c == Color::White ? 0 : color();
 	}
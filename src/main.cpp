@@ -16,13 +16,21 @@
  * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+
 #include "uci.h"
 #include "bench.h"
+#include "perft.h"
 #include "datagen/datagen.h"
+#include "datagen/filter.h"
+#include "datagen/datastat.h"
 #include "util/parse.h"
 #include "eval/nnue.h"
 #include "tunable.h"
-#include "cuckoo.h"
 
 #if SPJ_EXTERNAL_TUNE
 #include "util/split.h"
@@ -33,7 +41,6 @@ using namespace stormphranj;
 auto main(i32 argc, const char *argv[]) -> i32
 {
 	tunable::init();
-	cuckoo::init();
 
 	eval::loadDefaultNetwork();
 
@@ -48,12 +55,15 @@ auto main(i32 argc, const char *argv[]) -> i32
 
 			return 0;
 		}
+		else if (mode == "perftsuite")
+			return perftSuite() ? 0 : 1;
 		else if (mode == "datagen")
 		{
 			const auto printUsage = [&]()
 			{
 				std::cerr << "usage: " << argv[0]
 					<< " datagen <marlinformat/viri_binpack> <path> [threads] [game limit per thread]"
+					<< " [--book <epd/fen file>] [--random-moves <count>]"
 					<< std::endl;
 			};
 
@@ -63,23 +73,182 @@ auto main(i32 argc, const char *argv[]) -> i32
 				return 1;
 			}
 
+			datagen::Options options{};
+			std::vector<std::string> positional{};
+
+			for (i32 i = 4; i < argc; ++i)
+			{
+				const std::string arg{argv[i]};
+
+				if (arg == "--book")
+				{
+					if (++i == argc)
+					{
+						printUsage();
+						return 1;
+					}
+
+					options.book = argv[i];
+				}
+				else if (arg == "--random-moves")
+				{
+					u32 randomMoves{};
+					if (++i == argc || !util::tryParseU32(randomMoves, argv[i]))
+					{
+						std::cerr << "invalid number of random moves" << std::endl;
+						printUsage();
+						return 1;
+					}
+
+					options.randomMoves = randomMoves;
+				}
+				else positional.push_back(arg);
+			}
+
 			u32 threads = 1;
-			if (argc > 4 && !util::tryParseU32(threads, argv[4]))
+			if (positional.size() > 0 && !util::tryParseU32(threads, positional[0]))
 			{
-				std::cerr << "invalid number of threads " << argv[4] << std::endl;
+				std::cerr << "invalid number of threads " << positional[0] << std::endl;
 				printUsage();
 				return 1;
 			}
 
 			auto games = datagen::UnlimitedGames;
-			if (argc > 5 && !util::tryParseU32(games, argv[5]))
+			if (positional.size() > 1 && !util::tryParseU32(games, positional[1]))
+			{
+				std::cerr << "invalid number of games " << positional[1] << std::endl;
+				printUsage();
+				return 1;
+			}
+
+			return datagen::run(printUsage, argv[2], argv[3], static_cast<i32>(threads), games, options);
+		}
+		else if (mode == "datafilter")
+		{
+			const auto printUsage = [&]()
+			{
+				std::cerr << "usage: " << argv[0]
+					<< " datafilter <marlinformat/viri_binpack> <output dir> <input files...>"
+					<< " [--threads <n>] [--shards <n>] [--dedup-mb <n, 0 to disable>]"
+					<< " [--min-ply <n>] [--max-ply <n>] [--min-score <n>] [--max-score <n>]"
+					<< " [--min-pieces <n>] [--max-pieces <n>]"
+					<< std::endl;
+			};
+
+			if (argc < 5)
+			{
+				printUsage();
+				return 1;
+			}
+
+			const auto format = datagen::parseDataFormat(argv[2]);
+
+			if (!format)
+			{
+				std::cerr << "invalid input format " << argv[2] << std::endl;
+				printUsage();
+				return 1;
+			}
+
+			datagen::FilterOptions options{};
+			std::vector<std::string> inputs{};
+
+			const std::array<std::pair<std::string, u32 *>, 9> numericOptions{{
+				{"--threads", &options.threads},
+				{"--shards", &options.shards},
+				{"--dedup-mb", &options.dedupMb},
+				{"--min-ply", &options.minPly},
+				{"--max-ply", &options.maxPly},
+				{"--min-score", &options.minScore},
+				{"--max-score", &options.maxScore},
+				{"--min-pieces", &options.minPieces},
+				{"--max-pieces", &options.maxPieces}
+			}};
+
+			for (i32 i = 4; i < argc; ++i)
+			{
+				const std::string arg{argv[i]};
+
+				if (arg.starts_with("--"))
+				{
+					const auto option = std::find_if(numericOptions.begin(), numericOptions.end(),
+						[&](const auto &o) { return o.first == arg; });
+
+					if (option == numericOptions.end())
+					{
+						std::cerr << "unknown option " << arg << std::endl;
+						printUsage();
+						return 1;
+					}
+
+					if (++i == argc || !util::tryParseU32(*option->second, argv[i]))
+					{
+						std::cerr << "invalid value for " << arg << std::endl;
+						printUsage();
+						return 1;
+					}
+				}
+				else inputs.push_back(arg);
+			}
+
+			if (inputs.empty() || options.threads == 0 || options.shards == 0)
+			{
+				printUsage();
+				return 1;
+			}
+
+			return datagen::runFilter(*format, inputs, argv[3], options);
+		}
+		else if (mode == "datastat")
+		{
+			const auto printUsage = [&]()
+			{
+				std::cerr << "usage: " << argv[0]
+					<< " datastat <marlinformat/viri_binpack> <input files...> [--threads <n>]"
+					<< std::endl;
+			};
+
+			if (argc < 4)
+			{
+				printUsage();
+				return 1;
+			}
+
+			const auto format = datagen::parseDataFormat(argv[2]);
+
+			if (!format)
+			{
+				std::cerr << "invalid input format " << argv[2] << std::endl;
+				printUsage();
+				return 1;
+			}
+
+			u32 threads = 1;
+			std::vector<std::string> inputs{};
+
+			for (i32 i = 3; i < argc; ++i)
+			{
+				const std::string arg{argv[i]};
+
+				if (arg == "--threads")
+				{
+					if (++i == argc || !util::tryParseU32(threads, argv[i]) || threads == 0)
+					{
+						std::cerr << "invalid number of threads" << std::endl;
+						printUsage();
+						return 1;
+					}
+				}
+				else inputs.push_back(arg);
+			}
+
+			if (inputs.empty())
 			{
-				std::cerr << "invalid number of games " << argv[5] << std::endl;
 				printUsage();
 				return 1;
 			}
 
-			return datagen::run(printUsage, argv[2], argv[3], static_cast<i32>(threads), games);
+			return datagen::runDatastat(*format, inputs, threads);
 		}
 #if SPJ_EXTERNAL_TUNE
 		else if (mode == "printwf"
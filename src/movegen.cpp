@@ -79,14 +79,20 @@ namespace stormphranj
 			const auto forwardDstMask = dstMask & PromotionRank & ~theirs;
 
 			const auto pawns = bbs.pawns<Us>();
+			const auto pinned = pos.pinned();
 
-			const auto leftAttacks = pawns.template shiftUpLeftRelative<Us>() & dstMask;
-			const auto rightAttacks = pawns.template shiftUpRightRelative<Us>() & dstMask;
+			// pins are orthogonal, so pinned pawns can never capture,
+			// and can only push if they are pinned along the king's file
+			const auto capturers = pawns & ~pinned;
+			const auto pushers = pawns & (~pinned | boards::Files[squareFile(pos.king(Us))]);
+
+			const auto leftAttacks = capturers.template shiftUpLeftRelative<Us>() & dstMask;
+			const auto rightAttacks = capturers.template shiftUpRightRelative<Us>() & dstMask;
 
 			pushPromotions(noisy, LeftOffset,   leftAttacks & theirs & PromotionRank);
 			pushPromotions(noisy, RightOffset, rightAttacks & theirs & PromotionRank);
 
-			const auto forwards = pawns.template shiftUpRelative<Us>() & forwardDstMask;
+			const auto forwards = pushers.template shiftUpRelative<Us>() & forwardDstMask;
 			pushPromotions(noisy, ForwardOffset, forwards);
 
 			pushStandards(noisy,  LeftOffset,  leftAttacks & theirs & ~PromotionRank);
@@ -101,7 +107,7 @@ namespace stormphranj
 		}
 
 		template <Color Us>
-		auto generatePawnsQuiet_(ScoredMoveList &quiet, const BitboardSet &bbs, Bitboard dstMask, Bitboard occ)
+		auto generatePawnsQuiet_(ScoredMoveList &quiet, const Position &pos, Bitboard dstMask, Bitboard occ)
 		{
 			constexpr auto PromotionRank = boards::promotionRank<Us>();
 
@@ -109,25 +115,27 @@ namespace stormphranj
 
 			const auto forwardDstMask = dstMask & ~PromotionRank & ~occ;
 
-			const auto pawns = bbs.pawns<Us>();
+			const auto pawns = pos.bbs().pawns<Us>();
+			const auto pushers = pawns & (~pos.pinned() | boards::Files[squareFile(pos.king(Us))]);
 
-			const auto forwards = pawns.template shiftUpRelative<Us>() & forwardDstMask;
+			const auto forwards = pushers.template shiftUpRelative<Us>() & forwardDstMask;
 			pushStandards(quiet, ForwardOffset, forwards);
 		}
 
 		inline auto generatePawnsQuiet(ScoredMoveList &quiet, const Position &pos, Bitboard dstMask, Bitboard occ)
 		{
 			if (pos.toMove() == Color::Black)
-				generatePawnsQuiet_<Color::Black>(quiet, pos.bbs(), dstMask, occ);
-			else generatePawnsQuiet_<Color::White>(quiet, pos.bbs(), dstMask, occ);
+				generatePawnsQuiet_<Color::Black>(quiet, pos, dstMask, occ);
+			else generatePawnsQuiet_<Color::White>(quiet, pos, dstMask, occ);
 		}
 
+		// alfils, ferzes and knights always leave the line they are pinned along
 		template <PieceType Piece, const std::array<Bitboard, 64> &Attacks>
 		inline auto precalculated(ScoredMoveList &dst, const Position &pos, Bitboard dstMask)
 		{
 			const auto us = pos.toMove();
 
-			auto pieces = pos.bbs().forPiece(Piece, us);
+			auto pieces = pos.bbs().forPiece(Piece, us) & ~pos.pinned();
 			while (!pieces.empty())
 			{
 				const auto srcSquare = pieces.popLowestSquare();
@@ -154,7 +162,29 @@ namespace stormphranj
 
 		auto generateKings(ScoredMoveList &dst, const Position &pos, Bitboard dstMask)
 		{
-			precalculated<PieceType::King, attacks::KingAttacks>(dst, pos, dstMask);
+			const auto &bbs = pos.bbs();
+
+			const auto us = pos.toMove();
+			const auto king = pos.king(us);
+
+			dstMask &= ~pos.threats();
+
+			// threats are calculated with our king on the board, so
+			// squares behind it on a checking rook's line are still open
+			auto rookCheckers = pos.checkers() & bbs.rooks(oppColor(us));
+
+			if (!rookCheckers.empty())
+			{
+				const auto kinglessOcc = bbs.occupancy() ^ bbs.kings(us);
+
+				while (!rookCheckers.empty())
+				{
+					const auto checker = rookCheckers.popLowestSquare();
+					dstMask &= ~attacks::getRookAttacks(checker, kinglessOcc);
+				}
+			}
+
+			pushStandards(dst, king, attacks::getKingAttacks(king) & dstMask);
 		}
 
 		auto generateRooks(ScoredMoveList &dst, const Position &pos, Bitboard dstMask)
@@ -169,12 +199,19 @@ namespace stormphranj
 
 			const auto occupancy = ours | theirs;
 
+			const auto king = pos.king(us);
+			const auto pinned = pos.pinned();
+
 			auto rooks = bbs.rooks(us);
 
 			while (!rooks.empty())
 			{
 				const auto src = rooks.popLowestSquare();
-				const auto attacks = attacks::getRookAttacks(src, occupancy);
+
+				auto attacks = attacks::getRookAttacks(src, occupancy);
+
+				if (pinned[src])
+					attacks &= orthoRayIntersecting(src, king);
 
 				pushStandards(dst, src, attacks & dstMask);
 			}
@@ -208,7 +245,7 @@ namespace stormphranj
 			}
 
 			dstMask = pos.checkers();
-			pawnDstMask = kingDstMask | (promos & orthoRayBetween(pos.king(us), pos.checkers().lowestSquare()));
+			pawnDstMask = dstMask | (promos & orthoRayBetween(pos.king(us), pos.checkers().lowestSquare()));
 		}
 
 		generateAlfils(noisy, pos, dstMask);
@@ -252,34 +289,54 @@ namespace stormphranj
 		generateKings(quiet, pos, kingDstMask);
 	}
 
-	auto generateAll(ScoredMoveList &dst, const Position &pos) -> void
+	auto generateEvasions(ScoredMoveList &dst, const Position &pos) -> void
 	{
+		assert(pos.isCheck());
+
 		const auto &bbs = pos.bbs();
 
 		const auto us = pos.toMove();
 
-		const auto kingDstMask = ~bbs.forColor(pos.toMove());
+		const auto kingDstMask = ~bbs.forColor(us);
 
-		auto dstMask = kingDstMask;
+		// only the king can escape a double check
+		if (pos.checkers().multiple())
+		{
+			generateKings(dst, pos, kingDstMask);
+			return;
+		}
+
+		// capture the checker, or block it if it is a rook
+		const auto dstMask = pos.checkers()
+			| orthoRayBetween(pos.king(us), pos.checkers().lowestSquare());
 
+		generateAlfils(dst, pos, dstMask);
+		generateFerzes(dst, pos, dstMask);
+		generateRooks(dst, pos, dstMask);
+		generatePawnsNoisy(dst, pos, dstMask);
+		generatePawnsQuiet(dst, pos, dstMask, bbs.occupancy());
+		generateKnights(dst, pos, dstMask);
+		generateKings(dst, pos, kingDstMask);
+	}
+
+	auto generateAll(ScoredMoveList &dst, const Position &pos) -> void
+	{
 		if (pos.isCheck())
 		{
-			if (pos.checkers().multiple())
-			{
-				generateKings(dst, pos, kingDstMask);
-				return;
-			}
-
-			dstMask = pos.checkers()
-				| orthoRayBetween(pos.king(us), pos.checkers().lowestSquare());
+			generateEvasions(dst, pos);
+			return;
 		}
 
+		const auto &bbs = pos.bbs();
+
+		const auto dstMask = ~bbs.forColor(pos.toMove());
+
 		generateAlfils(dst, pos, dstMask);
 		generateFerzes(dst, pos, dstMask);
 		generateRooks(dst, pos, dstMask);
 		generatePawnsNoisy(dst, pos, dstMask);
 		generatePawnsQuiet(dst, pos, dstMask, bbs.occupancy());
 		generateKnights(dst, pos, dstMask);
-		generateKings(dst, pos, kingDstMask);
+		generateKings(dst, pos, dstMask);
 	}
 }
@@ -20,10 +20,13 @@
 
 #include "types.h"
 
+#include <vector>
+
 #include "move.h"
 #include "position/position.h"
 #include "see.h"
 #include "history.h"
+#include "profile.h"
 
 namespace stormphranj
 {
@@ -39,11 +42,22 @@ namespace stormphranj
 	{
 		ScoredMoveList moves;
 		std::array<i32, DefaultMoveListCapacity> histories;
+
+		// root only - moves have already been ordered by the searcher, only the tt move is moved to the front
+		bool preordered{false};
+		// root only - each move's rank in that order, the scores are rebuilt from it on every
+		// construction so that a previous tt move does not keep its tt move score. Kept out
+		// of the fixed size arrays, as only the root's movegen data ever uses it
+		std::vector<i32> ranks{};
 	};
 
+	// Generated moves are fully legal
 	auto generateNoisy(ScoredMoveList &noisy, const Position &pos) -> void;
 	auto generateQuiet(ScoredMoveList &quiet, const Position &pos) -> void;
 
+	// All legal moves when in check, noisy and quiet
+	auto generateEvasions(ScoredMoveList &dst, const Position &pos) -> void;
+
 	auto generateAll(ScoredMoveList &dst, const Position &pos) -> void;
 
 	struct MovegenStage
@@ -74,15 +88,27 @@ namespace stormphranj
 	{
 	public:
 		MoveGenerator(const Position &pos, Move killer, MovegenData &data, Move ttMove,
-			i32 ply = -1, std::span<const HistoryMove> prevMoves = {}, const HistoryTable *history = nullptr)
+			HistoryMove prevMove = {}, const ContinuationEntries &continuations = {},
+			const HistoryTable *history = nullptr)
 			: m_pos{pos},
 			  m_data{data},
 			  m_ttMove{ttMove},
-			  m_ply{ply},
-			  m_prevMoves{prevMoves},
+			  m_prevMove{prevMove},
+			  m_continuations{continuations},
 			  m_killer{killer},
 			  m_history{history}
 		{
+			// all evasions are generated at once in the noisy stage, and
+			// ordered together - the killer and countermove stages are skipped
+			if constexpr (!Root)
+			{
+				if (m_pos.isCheck())
+				{
+					m_evasion = true;
+					m_killer = NullMove;
+				}
+			}
+
 			if constexpr (Root)
 			{
 				static constexpr auto TtMoveScore = std::numeric_limits<i32>::max() - MovegenStage::TtMove;
@@ -93,7 +119,12 @@ namespace stormphranj
 				{
 					auto &move = data.moves[i];
 
-					if (move.move == m_ttMove)
+					if (data.preordered)
+					{
+						move.score = move.move == m_ttMove ? TtMoveScore : data.ranks[i];
+						data.histories[i] = moveHistory(move.move);
+					}
+					else if (move.move == m_ttMove)
 					{
 						move.score = TtMoveScore;
 						data.histories[i] = moveHistory(move.move);
@@ -109,23 +140,21 @@ namespace stormphranj
 						data.histories[i] = moveHistory(move.move);
 					}
 					else if (m_pos.isNoisy(move.move))
-						scoreNoisy(i);
-					else scoreQuiet(i);
+						scoreNoisy(i, m_pos.boards(), m_pos.threats());
+					else scoreQuiet(i, m_pos.boards(), m_pos.threats());
 				}
 
 				m_stage = MovegenStage::End;
 			}
-			else
-			{
-				m_data.moves.clear();
-				m_data.moves.fill({NullMove, 0});
-			}
+			else m_data.moves.clear();
 		}
 
 		~MoveGenerator() = default;
 
 		[[nodiscard]] inline auto next()
 		{
+			SPJ_PROFILE_SCOPE(Movegen);
+
 			if constexpr (Root)
 			{
 				if (m_idx == m_data.moves.size())
@@ -144,37 +173,49 @@ namespace stormphranj
 					switch (m_stage)
 					{
 					case MovegenStage::TtMove:
-						if (m_ttMove)
+						if (m_ttMove && m_pos.isLegal(m_ttMove))
 							return MoveWithHistory{m_ttMove, moveHistory(m_ttMove)};
 						break;
 
 					case MovegenStage::GoodNoisy:
-						genNoisy();
-						if constexpr (GoodNoisiesOnly)
-							m_stage = MovegenStage::End;
+						if (m_evasion)
+							genEvasions();
+						else
+						{
+							genNoisy();
+							if constexpr (GoodNoisiesOnly)
+								m_stage = MovegenStage::End;
+						}
 						break;
 
 					case MovegenStage::Killer:
 						if (m_killer
 							&& m_killer != m_ttMove
-							&& m_pos.isPseudolegal(m_killer))
+							&& m_pos.isPseudolegal(m_killer)
+							&& m_pos.isLegal(m_killer))
 							return MoveWithHistory{m_killer, moveHistory(m_killer)};
 						break;
 
 					case MovegenStage::Countermove:
-						if (m_history && m_ply > 0)
+						if (!m_evasion && m_history && m_prevMove)
 						{
-							m_countermove = m_history->countermove(m_ply, m_prevMoves);
+							m_countermove = m_history->countermove(m_prevMove);
 							if (m_countermove
 								&& m_countermove != m_ttMove
 								&& m_countermove != m_killer
-								&& m_pos.isPseudolegal(m_countermove))
+								&& m_pos.isPseudolegal(m_countermove)
+								&& m_pos.isLegal(m_countermove))
 								return MoveWithHistory{m_countermove, moveHistory(m_countermove)};
 						}
 						break;
 
 					case MovegenStage::Quiet:
-						genQuiet();
+						if (m_evasion)
+						{
+							m_sortedEnd = partialSort(m_idx, m_data.moves.size(), QuietSortThreshold);
+							m_goodNoisyEnd = 9999;
+						}
+						else genQuiet();
 						break;
 
 					case MovegenStage::BadNoisy:
@@ -213,6 +254,10 @@ namespace stormphranj
 		static constexpr i32 GoodNoisyBonus = 8 * 2000 * 2000;
 		static constexpr i32 GoodNoisyThreshold = GoodNoisyBonus / 2;
 
+		// quiets and bad noisies scoring at least this are sorted up front,
+		// the rest are selected lazily as they are needed
+		static constexpr i32 QuietSortThreshold = 1;
+
 		inline auto moveHistory(Move move) -> i32
 		{
 			if constexpr (!GoodNoisiesOnly)
@@ -224,7 +269,7 @@ namespace stormphranj
 
 					return noisy
 						? m_history->noisyScore(historyMove, m_pos.threats(), captured)
-						: m_history->quietScore(historyMove, m_pos.threats(), m_ply, m_prevMoves);
+						: m_history->quietScore(historyMove, m_pos.threats(), m_continuations);
 				}
 			}
 
@@ -233,8 +278,7 @@ namespace stormphranj
 
 		inline auto findNext()
 		{
-			// good noisies are already sorted
-			if (m_stage == MovegenStage::GoodNoisy)
+			if (m_idx < m_sortedEnd)
 				return m_idx++;
 
 			auto best = m_idx;
@@ -253,64 +297,126 @@ namespace stormphranj
 			{
 				std::swap(m_data.moves[m_idx], m_data.moves[best]);
 				std::swap(m_data.histories[m_idx], m_data.histories[best]);
+
+				if constexpr (Root)
+				{
+					if (m_data.preordered)
+						std::swap(m_data.ranks[m_idx], m_data.ranks[best]);
+				}
 			}
 
 			return m_idx++;
 		}
 
+		// Stable insertion sort of the moves in [begin, end) scoring at least limit to the front,
+		// in descending order. Moves below the limit are left unsorted behind them
+		inline auto partialSort(u32 begin, u32 end, i32 limit) -> u32
+		{
+			auto sortedEnd = begin;
+
+			for (auto i = begin; i < end; ++i)
+			{
+				if (m_data.moves[i].score < limit)
+					continue;
+
+				const auto move = m_data.moves[i];
+				const auto history = m_data.histories[i];
+
+				m_data.moves[i] = m_data.moves[sortedEnd];
+				m_data.histories[i] = m_data.histories[sortedEnd];
+
+				auto j = sortedEnd++;
+
+				for (; j > begin && m_data.moves[j - 1].score < move.score; --j)
+				{
+					m_data.moves[j] = m_data.moves[j - 1];
+					m_data.histories[j] = m_data.histories[j - 1];
+				}
+
+				m_data.moves[j] = move;
+				m_data.histories[j] = history;
+			}
+
+			return sortedEnd;
+		}
+
 		inline auto genNoisy()
 		{
 			generateNoisy(m_data.moves, m_pos);
 
-			for (i32 i = m_idx; i < m_data.moves.size(); ++i)
+			const auto &boards = m_pos.boards();
+			const auto threats = m_pos.threats();
+
+			const auto end = m_data.moves.size();
+
+			for (auto i = m_idx; i < end; ++i)
 			{
-				scoreNoisy(i);
+				scoreNoisy(i, boards, threats);
 			}
 
-			//FIXME this does not sort histories, so they're broken
-			std::stable_sort(m_data.moves.begin() + m_idx, m_data.moves.end(), [](const auto &a, const auto &b)
-			{
-				return a.score > b.score;
-			});
+			m_sortedEnd = m_goodNoisyEnd = partialSort(m_idx, end, GoodNoisyThreshold);
+		}
+
+		inline auto genEvasions()
+		{
+			generateEvasions(m_data.moves, m_pos);
+
+			const auto &boards = m_pos.boards();
+			const auto threats = m_pos.threats();
 
-			m_noisyEnd = m_data.moves.size();
+			const auto end = m_data.moves.size();
 
-			m_goodNoisyEnd = std::find_if(m_data.moves.begin() + m_idx, m_data.moves.end(), [](const auto &v)
+			for (auto i = m_idx; i < end; ++i)
 			{
-				return v.score < GoodNoisyThreshold;
-			}) - m_data.moves.begin();
+				if (m_pos.isNoisy(m_data.moves[i].move))
+					scoreNoisy(i, boards, threats);
+				else if (m_history)
+					scoreQuiet(i, boards, threats);
+			}
+
+			// good captures of the checker first, then everything else as in the quiet stage
+			m_sortedEnd = m_goodNoisyEnd = partialSort(m_idx, end, GoodNoisyThreshold);
 		}
 
 		inline auto genQuiet()
 		{
+			const auto noisyEnd = m_data.moves.size();
+
 			generateQuiet(m_data.moves, m_pos);
 
-			for (i32 i = m_noisyEnd; i < m_data.moves.size(); ++i)
+			const auto end = m_data.moves.size();
+
+			if (m_history)
 			{
-				scoreQuiet(i);
+				const auto &boards = m_pos.boards();
+				const auto threats = m_pos.threats();
+
+				for (auto i = noisyEnd; i < end; ++i)
+				{
+					scoreQuiet(i, boards, threats);
+				}
 			}
 
+			// bad noisies are still unsorted, and get ordered alongside the quiets
+			m_sortedEnd = partialSort(m_idx, end, QuietSortThreshold);
+
 			m_goodNoisyEnd = 9999;
 		}
 
-		inline auto scoreQuiet(i32 idx)
+		inline auto scoreQuiet(u32 idx, const PositionBoards &boards, Bitboard threats)
 		{
-			const auto &boards = m_pos.boards();
-
 			auto &move = m_data.moves[idx];
 
 			if (m_history)
 			{
 				const auto historyMove = HistoryMove::from(boards, move.move);
-				const auto historyScore = m_history->quietScore(historyMove, m_pos.threats(), m_ply, m_prevMoves);
+				const auto historyScore = m_history->quietScore(historyMove, threats, m_continuations);
 				m_data.histories[idx] = move.score = historyScore;
 			}
 		}
 
-		inline auto scoreNoisy(i32 idx)
+		inline auto scoreNoisy(u32 idx, const PositionBoards &boards, Bitboard threats)
 		{
-			const auto &boards = m_pos.boards();
-
 			auto &move = m_data.moves[idx];
 
 			const auto captured = boards.pieceAt(move.move.dst());
@@ -318,7 +424,7 @@ namespace stormphranj
 			if (m_history)
 			{
 				const auto historyMove = HistoryMove::from(boards, move.move);
-				const auto historyScore = m_history->noisyScore(historyMove, m_pos.threats(), captured);
+				const auto historyScore = m_history->noisyScore(historyMove, threats, captured);
 				m_data.histories[idx] = move.score = historyScore;
 			}
 
@@ -338,8 +444,8 @@ namespace stormphranj
 
 		Move m_ttMove;
 
-		i32 m_ply;
-		std::span<const HistoryMove> m_prevMoves;
+		HistoryMove m_prevMove;
+		ContinuationEntries m_continuations;
 
 		Move m_killer;
 
@@ -349,8 +455,10 @@ namespace stormphranj
 
 		u32 m_idx{};
 
-		u32 m_noisyEnd{};
 		u32 m_goodNoisyEnd{};
+		u32 m_sortedEnd{};
+
+		bool m_evasion{false};
 	};
 
 	using QMoveGenerator = MoveGenerator<false, true>;
@@ -19,6 +19,7 @@
 #include "perft.h"
 
 #include <iostream>
+#include <array>
 
 #include "movegen.h"
 #include "uci.h"
@@ -42,9 +43,6 @@ namespace stormphranj
 
 			for (const auto [move, score] : moves)
 			{
-				if (!pos.isLegal(move))
-					continue;
-
 				const auto guard = pos.applyMove<false>(move, nullptr);
 
 				total += depth == 0 ? 1 : doPerft(pos, depth);
@@ -52,6 +50,38 @@ namespace stormphranj
 
 			return total;
 		}
+
+		struct PerftCase
+		{
+			const char *fen;
+			i32 depth;
+			usize nodes;
+		};
+
+		// counts verified against the pseudolegal generator with legality filtering
+		const std::array PerftSuite {
+			PerftCase{"rnbkqbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBKQBNR w - - 0 1", 5, 1164248},
+			PerftCase{"r2k1r2/4n1p1/p1n1q2p/1pP1p3/1b1p4/B2B2PP/P2PNN1R/K1R1Q3 w - - 1 25", 4, 617300},
+			PerftCase{"3kq3/3p4/3p1p2/6pK/1R1Q4/1P1B1r2/8/8 w - - 2 44", 5, 1124251},
+			PerftCase{"8/4k3/4R3/2PK4/1P3Nn1/P2PPn2/5r2/8 b - - 2 58", 5, 1059511},
+			// promotions
+			PerftCase{"1r6/2P1P3/3k4/8/8/3K4/1p1p4/2R5 w - - 0 1", 5, 2640366},
+			PerftCase{"8/8/3k4/8/2R5/8/3K4/8 b - - 0 1", 5, 79085},
+			// checks
+			PerftCase{"3r4/8/3N4/3k4/3R4/8/3K4/8 b - - 0 1", 5, 428278},
+			PerftCase{"4r3/8/8/4P3/8/4K2r/8/k7 w - - 0 1", 5, 143680},
+			PerftCase{"k7/8/8/8/8/8/r3K3/7r w - - 0 1", 6, 2190749},
+			PerftCase{"4k3/8/8/8/8/5n2/3P4/4K2R w - - 0 1", 5, 149534},
+			// double check
+			PerftCase{"k3r3/8/8/8/8/3n4/7R/4K3 w - - 0 1", 5, 319379},
+			// pins
+			PerftCase{"3r4/8/8/3R4/8/8/3K4/k7 w - - 0 1", 6, 8380024},
+			PerftCase{"8/8/8/r2PK3/8/8/8/k7 w - - 0 1", 6, 1105379},
+			PerftCase{"3r4/8/8/8/3P4/3K4/8/k7 w - - 0 1", 6, 1316200},
+			PerftCase{"3r4/3n4/3q4/8/3P4/3K4/8/k3r3 w - - 0 1", 5, 157333},
+			// check with a pinned blocker
+			PerftCase{"r3k3/8/8/8/4R3/8/4N2r/4K3 b - - 0 1", 5, 1056285},
+		};
 	}
 
 	auto perft(Position &pos, i32 depth) -> void
@@ -72,9 +102,6 @@ namespace stormphranj
 
 		for (const auto [move, score] : moves)
 		{
-			if (!pos.isLegal(move))
-				continue;
-
 			const auto guard = pos.applyMove<false>(move, nullptr);
 
 			const auto value = doPerft(pos, depth);
@@ -89,4 +116,50 @@ namespace stormphranj
 		std::cout << "\ntotal " << total << '\n';
 		std::cout << nps << " nps" << std::endl;
 	}
+
+	auto perftSuite() -> bool
+	{
+		const auto start = util::g_timer.time();
+
+		u32 failed{};
+
+		for (usize i = 0; i < PerftSuite.size(); ++i)
+		{
+			const auto &[fen, depth, expected] = PerftSuite[i];
+
+			std::cout << "info string perft " << (i + 1) << "/" << PerftSuite.size()
+				<< " depth " << depth << " " << fen << ": ";
+
+			Position pos{};
+
+			if (!pos.resetFromFen(fen))
+			{
+				std::cout << "INVALID FEN" << std::endl;
+				++failed;
+				continue;
+			}
+
+			const auto nodes = doPerft(pos, depth);
+
+			if (nodes == expected)
+				std::cout << nodes << " ok" << std::endl;
+			else
+			{
+				std::cout << nodes << " MISMATCH, expected " << expected << std::endl;
+				++failed;
+			}
+		}
+
+		const auto time = util::g_timer.time() - start;
+
+		if (failed > 0)
+		{
+			std::cout << "info string perft suite FAILED: " << failed << " of "
+				<< PerftSuite.size() << " positions wrong" << std::endl;
+			return false;
+		}
+
+		std::cout << "info string perft suite passed in " << time << " seconds" << std::endl;
+		return true;
+	}
 }
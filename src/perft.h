@@ -27,4 +27,8 @@ namespace stormphranj
 {
 	auto perft(Position &pos, i32 depth) -> void;
 	auto splitPerft(Position &pos, i32 depth) -> void;
+
+	// Runs perft on a fixed set of positions with known node counts, including
+	// checks, double checks and pins. Reports every mismatch, returns false if any
+	auto perftSuite() -> bool;
 }
@@ -273,137 +273,95 @@ namespace stormphranj
 		std::array<Bitboard, 6> m_pieces{};
 	};
 
-	class PositionBoards
+	// Lives in Position rather than BoardState - it is updated in place on
+	// make and restored on unmake, so it is not copied on every move
+	class Mailbox
 	{
 	public:
-		PositionBoards()
+		Mailbox()
 		{
-			m_mailbox.fill(Piece::None);
+			m_pieces.fill(Piece::None);
 		}
 
-		~PositionBoards() = default;
-
-		[[nodiscard]] inline auto bbs() const -> const auto &
-		{
-			return m_bbs;
-		}
-
-		[[nodiscard]] inline auto bbs() -> auto &
-		{
-			return m_bbs;
-		}
-
-		[[nodiscard]] inline auto pieceTypeAt(Square square) const
-		{
-			assert(square != Square::None);
-
-			const auto piece = m_mailbox[static_cast<i32>(square)];
-			return piece == Piece::None ? PieceType::None : pieceType(piece);
-		}
+		~Mailbox() = default;
 
 		[[nodiscard]] inline auto pieceAt(Square square) const
 		{
 			assert(square != Square::None);
-			return m_mailbox[static_cast<i32>(square)];
+			return m_pieces[static_cast<i32>(square)];
 		}
 
-		[[nodiscard]] inline auto pieceAt(u32 rank, u32 file) const
-		{
-			return pieceAt(toSquare(rank, file));
-		}
-
-		inline auto setPiece(Square square, Piece piece)
+		[[nodiscard]] inline auto operator[](Square square) -> Piece &
 		{
 			assert(square != Square::None);
-			assert(piece != Piece::None);
-
-			assert(pieceAt(square) == Piece::None);
-
-			slot(square) = piece;
-
-			const auto mask = Bitboard::fromSquare(square);
-
-			m_bbs.forPiece(pieceType(piece)) ^= mask;
-			m_bbs.forColor(pieceColor(piece)) ^= mask;
+			return m_pieces[static_cast<i32>(square)];
 		}
 
-		inline auto movePiece(Square src, Square dst, Piece piece)
+		inline auto regenFromBbs(const BitboardSet &bbs)
 		{
-			assert(src != Square::None);
-			assert(dst != Square::None);
+			m_pieces.fill(Piece::None);
 
-			if (slot(src) == piece) [[likely]]
-				slot(src) = Piece::None;
-			slot(dst) = piece;
-
-			const auto mask = Bitboard::fromSquare(src) ^ Bitboard::fromSquare(dst);
+			for (u32 pieceIdx = 0; pieceIdx < 12; ++pieceIdx)
+			{
+				const auto piece = static_cast<Piece>(pieceIdx);
 
-			m_bbs.forPiece(pieceType(piece)) ^= mask;
-			m_bbs.forColor(pieceColor(piece)) ^= mask;
+				auto board = bbs.forPiece(piece);
+				while (!board.empty())
+				{
+					const auto sq = board.popLowestSquare();
+					assert((*this)[sq] == Piece::None);
+					(*this)[sq] = piece;
+				}
+			}
 		}
 
-		inline auto moveAndChangePiece(Square src, Square dst, Piece moving, PieceType promo)
-		{
-			assert(src != Square::None);
-			assert(dst != Square::None);
-			assert(src != dst);
-
-			assert(moving != Piece::None);
-			assert(promo != PieceType::None);
+		[[nodiscard]] inline auto operator==(const Mailbox &other) const -> bool = default;
 
-			assert(pieceAt(src) == moving);
-			assert(slot(src) == moving);
+	private:
+		std::array<Piece, 64> m_pieces{};
+	};
 
-			slot(src) = Piece::None;
-			slot(dst) = copyPieceColor(moving, promo);
+	// Read-only view of a position's bitboards and mailbox
+	class PositionBoards
+	{
+	public:
+		PositionBoards(const BitboardSet &bbs, const Mailbox &mailbox)
+			: m_bbs{&bbs},
+			  m_mailbox{&mailbox} {}
 
-			m_bbs.forPiece(pieceType(moving))[src] = false;
-			m_bbs.forPiece(promo)[dst] = true;
+		~PositionBoards() = default;
 
-			const auto mask = Bitboard::fromSquare(src) ^ Bitboard::fromSquare(dst);
-			m_bbs.forColor(pieceColor(moving)) ^= mask;
+		[[nodiscard]] inline auto bbs() const -> const auto &
+		{
+			return *m_bbs;
 		}
 
-		inline auto removePiece(Square square, Piece piece)
+		[[nodiscard]] inline auto pieceTypeAt(Square square) const
 		{
 			assert(square != Square::None);
-			assert(piece != Piece::None);
-
-			assert(pieceAt(square) == piece);
 
-			slot(square) = Piece::None;
-
-			m_bbs.forPiece(pieceType(piece))[square] = false;
-			m_bbs.forColor(pieceColor(piece))[square] = false;
+			const auto piece = m_mailbox->pieceAt(square);
+			return piece == Piece::None ? PieceType::None : pieceType(piece);
 		}
 
-		inline auto regenFromBbs()
+		[[nodiscard]] inline auto pieceAt(Square square) const
 		{
-			m_mailbox.fill(Piece::None);
-
-			for (u32 pieceIdx = 0; pieceIdx < 12; ++pieceIdx)
-			{
-				const auto piece = static_cast<Piece>(pieceIdx);
-
-				auto board = m_bbs.forPiece(piece);
-				while (!board.empty())
-				{
-					const auto sq = board.popLowestSquare();
-					assert(slot(sq) == Piece::None);
-					slot(sq) = piece;
-				}
-			}
+			assert(square != Square::None);
+			return m_mailbox->pieceAt(square);
 		}
 
-		[[nodiscard]] inline auto operator==(const PositionBoards &other) const -> bool = default;
+		[[nodiscard]] inline auto pieceAt(u32 rank, u32 file) const
+		{
+			return pieceAt(toSquare(rank, file));
+		}
 
-	private:
-		[[nodiscard]] inline auto slot(Square square) -> Piece &
+		[[nodiscard]] inline auto operator==(const PositionBoards &other) const
 		{
-			return m_mailbox[static_cast<i32>(square)];
+			return *m_bbs == *other.m_bbs && *m_mailbox == *other.m_mailbox;
 		}
 
-		BitboardSet m_bbs{};
-		std::array<Piece, 64> m_mailbox{};
+	private:
+		const BitboardSet *m_bbs;
+		const Mailbox *m_mailbox;
 	};
 }
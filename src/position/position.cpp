@@ -35,6 +35,7 @@
 #include "../opts.h"
 #include "../rays.h"
 #include "../cuckoo.h"
+#include "../profile.h"
 
 namespace stormphranj
 {
@@ -88,7 +89,7 @@ namespace stormphranj
 		auto &state = currState();
 		state = BoardState{};
 
-		auto &bbs = state.boards.bbs();
+		auto &bbs = state.bbs;
 
 		bbs.forPiece(PieceType::  Pawn) = U64(0x00FF00000000FF00);
 		bbs.forPiece(PieceType:: Alfil) = U64(0x2400000000000024);
@@ -106,54 +107,58 @@ namespace stormphranj
 		regen();
 	}
 
-	auto Position::resetFromFen(const std::string &fen) -> bool
+	auto Position::resetFromFen(const std::string &fen, bool quiet) -> bool
 	{
+		// an ostream without a buffer discards everything written to it
+		std::ostream nullStream{nullptr};
+		auto &err = quiet ? nullStream : std::cerr;
+
 		const auto tokens = split::split(fen, ' ');
 
 		if (tokens.size() > 6)
 		{
-			std::cerr << "excess tokens after fullmove number in fen " << fen << std::endl;
+			err << "excess tokens after fullmove number in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.size() == 5)
 		{
-			std::cerr << "missing fullmove number in fen " << fen << std::endl;
+			err << "missing fullmove number in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.size() == 4)
 		{
-			std::cerr << "missing halfmove clock in fen " << fen << std::endl;
+			err << "missing halfmove clock in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.size() == 3)
 		{
-			std::cerr << "missing fourth field in fen " << fen << std::endl;
+			err << "missing fourth field in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.size() == 2)
 		{
-			std::cerr << "missing third field in fen " << fen << std::endl;
+			err << "missing third field in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.size() == 1)
 		{
-			std::cerr << "missing next move color in fen " << fen << std::endl;
+			err << "missing next move color in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens.empty())
 		{
-			std::cerr << "missing ranks in fen " << fen << std::endl;
+			err << "missing ranks in fen " << fen << std::endl;
 			return false;
 		}
 
 		BoardState newState{};
-		auto &newBbs = newState.boards.bbs();
+		auto &newBbs = newState.bbs;
 
 		u32 rankIdx = 0;
 
@@ -162,7 +167,7 @@ namespace stormphranj
 		{
 			if (rankIdx >= 8)
 			{
-				std::cerr << "too many ranks in fen " << fen << std::endl;
+				err << "too many ranks in fen " << fen << std::endl;
 				return false;
 			}
 
@@ -172,7 +177,7 @@ namespace stormphranj
 			{
 				if (fileIdx >= 8)
 				{
-					std::cerr << "too many files in rank " << rankIdx << " in fen " << fen << std::endl;
+					err << "too many files in rank " << rankIdx << " in fen " << fen << std::endl;
 					return false;
 				}
 
@@ -180,12 +185,16 @@ namespace stormphranj
 					fileIdx += *emptySquares;
 				else if (const auto piece = pieceFromChar(c); piece != Piece::None)
 				{
-					newState.boards.setPiece(toSquare(7 - rankIdx, fileIdx), piece);
+					const auto square = toSquare(7 - rankIdx, fileIdx);
+
+					newBbs.forPiece(pieceType(piece))[square] = true;
+					newBbs.forColor(pieceColor(piece))[square] = true;
+
 					++fileIdx;
 				}
 				else
 				{
-					std::cerr << "invalid piece character " << c << " in fen " << fen << std::endl;
+					err << "invalid piece character " << c << " in fen " << fen << std::endl;
 					return false;
 				}
 			}
@@ -193,13 +202,13 @@ namespace stormphranj
 			// last character was a digit
 			if (fileIdx > 8)
 			{
-				std::cerr << "too many files in rank " << rankIdx << " in fen " << fen << std::endl;
+				err << "too many files in rank " << rankIdx << " in fen " << fen << std::endl;
 				return false;
 			}
 
 			if (fileIdx < 8)
 			{
-				std::cerr << "not enough files in rank " << rankIdx << " in fen " << fen << std::endl;
+				err << "not enough files in rank " << rankIdx << " in fen " << fen << std::endl;
 				return false;
 			}
 
@@ -209,20 +218,20 @@ namespace stormphranj
 		if (const auto blackKingCount = newBbs.forPiece(Piece::BlackKing).popcount();
 			blackKingCount != 1)
 		{
-			std::cerr << "black must have exactly 1 king, " << blackKingCount << " in fen " << fen << std::endl;
+			err << "black must have exactly 1 king, " << blackKingCount << " in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (const auto whiteKingCount = newBbs.forPiece(Piece::WhiteKing).popcount();
 			whiteKingCount != 1)
 		{
-			std::cerr << "white must have exactly 1 king, " << whiteKingCount << " in fen " << fen << std::endl;
+			err << "white must have exactly 1 king, " << whiteKingCount << " in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (newBbs.occupancy().popcount() > 32)
 		{
-			std::cerr << "too many pieces in fen " << fen << std::endl;
+			err << "too many pieces in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -230,7 +239,7 @@ namespace stormphranj
 
 		if (color.length() != 1)
 		{
-			std::cerr << "invalid next move color in fen " << fen << std::endl;
+			err << "invalid next move color in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -241,7 +250,7 @@ namespace stormphranj
 		case 'b': newBlackToMove = true; break;
 		case 'w': break;
 		default:
-			std::cerr << "invalid next move color in fen " << fen << std::endl;
+			err << "invalid next move color in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -250,19 +259,19 @@ namespace stormphranj
 				newBbs.forPiece(PieceType::King, oppColor(stm)).lowestSquare(),
 				stm))
 		{
-			std::cerr << "opponent must not be in check" << std::endl;
+			err << "opponent must not be in check" << std::endl;
 			return false;
 		}
 
 		if (tokens[2] != "-")
 		{
-			std::cerr << "invalid 3rd field in fen " << fen << std::endl;
+			err << "invalid 3rd field in fen " << fen << std::endl;
 			return false;
 		}
 
 		if (tokens[3] != "-")
 		{
-			std::cerr << "invalid 4th field in fen " << fen << std::endl;
+			err << "invalid 4th field in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -272,7 +281,7 @@ namespace stormphranj
 			newState.halfmove = *halfmove;
 		else
 		{
-			std::cerr << "invalid halfmove clock in fen " << fen << std::endl;
+			err << "invalid halfmove clock in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -284,7 +293,7 @@ namespace stormphranj
 			newFullmove = *fullmove;
 		else
 		{
-			std::cerr << "invalid fullmove number in fen " << fen << std::endl;
+			err << "invalid fullmove number in fen " << fen << std::endl;
 			return false;
 		}
 
@@ -301,12 +310,42 @@ namespace stormphranj
 		return true;
 	}
 
+	auto Position::resetFromBbs(const BitboardSet &bbs, Color stm, u32 halfmove, u32 fullmove) -> bool
+	{
+		if (bbs.blackKings().popcount() != 1
+			|| bbs.whiteKings().popcount() != 1
+			|| !(bbs.blackOccupancy() & bbs.whiteOccupancy()).empty()
+			|| bbs.occupancy().popcount() > 32)
+			return false;
+
+		BoardState newState{};
+
+		newState.bbs = bbs;
+		newState.halfmove = halfmove;
+
+		if (isAttacked<false>(newState, stm, bbs.kings(oppColor(stm)).lowestSquare(), stm))
+			return false;
+
+		m_states.resize(1);
+		m_keys.clear();
+
+		m_blackToMove = stm == Color::Black;
+		m_fullmove = std::max(fullmove, 1U);
+
+		currState() = newState;
+
+		regen();
+
+		return true;
+	}
+
 	auto Position::copyStateFrom(const Position &other) -> void
 	{
 		m_states.clear();
 		m_keys.clear();
 
 		m_states.push_back(other.currState());
+		m_mailbox = other.m_mailbox;
 
 		m_blackToMove = other.m_blackToMove;
 		m_fullmove = other.m_fullmove;
@@ -349,8 +388,7 @@ namespace stormphranj
 			}
 #endif
 
-			state.pinned = calcPinned();
-			state.threats = calcThreats();
+			state.dirty = BoardState::DirtyAll;
 
 			return;
 		}
@@ -365,7 +403,7 @@ namespace stormphranj
 		if (stm == Color::Black)
 			++m_fullmove;
 
-		const auto moving = state.boards.pieceAt(moveSrc);
+		const auto moving = m_mailbox.pieceAt(moveSrc);
 
 #ifndef NDEBUG
 		if (moving == Piece::None)
@@ -389,18 +427,19 @@ namespace stormphranj
 			break;
 		}
 
+		state.captured = captured;
+
 		if constexpr (UpdateNnue)
 			nnueState->update<StateHistory>(updates,
-				state.boards.bbs(), state.blackKing(), state.whiteKing());
+				state.bbs, state.blackKing(), state.whiteKing());
 
 		if (captured == Piece::None
 			&& pieceType(moving) != PieceType::Pawn)
 			++state.halfmove;
 		else state.halfmove = 0;
 
-		state.checkers = calcCheckers();
-		state.pinned = calcPinned();
-		state.threats = calcThreats();
+		state.checkers = calcCheckers(state, toMove());
+		state.dirty = BoardState::DirtyAll;
 
 #ifndef NDEBUG
 		if constexpr (VerifyAll)
@@ -425,16 +464,30 @@ namespace stormphranj
 			nnueState->pop();
 		}
 
+		const auto captured = currState().captured;
+
 		m_states.pop_back();
 		m_keys.pop_back();
 
 		m_blackToMove = !m_blackToMove;
 
-		if (!currState().lastMove)
+		const auto move = currState().lastMove;
+
+		if (!move)
 			return;
 
 		if (toMove() == Color::Black)
 			--m_fullmove;
+
+		const auto src = move.src();
+		const auto dst = move.dst();
+
+		const auto moved = m_mailbox.pieceAt(dst);
+
+		m_mailbox[src] = move.type() == MoveType::Promotion
+			? copyPieceColor(moved, PieceType::Pawn)
+			: moved;
+		m_mailbox[dst] = captured;
 	}
 
 	auto Position::clearStateHistory() -> void
@@ -453,13 +506,13 @@ namespace stormphranj
 		const auto us = toMove();
 
 		const auto src = move.src();
-		const auto srcPiece = state.boards.pieceAt(src);
+		const auto srcPiece = m_mailbox.pieceAt(src);
 
 		if (srcPiece == Piece::None || pieceColor(srcPiece) != us)
 			return false;
 
 		const auto dst = move.dst();
-		const auto dstPiece = state.boards.pieceAt(dst);
+		const auto dstPiece = m_mailbox.pieceAt(dst);
 
 		// we're capturing something
 		if (dstPiece != Piece::None
@@ -481,7 +534,7 @@ namespace stormphranj
 
 		const auto srcPieceType = pieceType(srcPiece);
 		const auto them = oppColor(us);
-		const auto occ = state.boards.bbs().occupancy();
+		const auto occ = state.bbs.occupancy();
 
 		if (srcPieceType == PieceType::Pawn)
 		{
@@ -503,7 +556,7 @@ namespace stormphranj
 			if (move.srcFile() != move.dstFile())
 			{
 				// not valid attack
-				if (!(attacks::getPawnAttacks(src, us) & state.boards.bbs().forColor(them))[dst])
+				if (!(attacks::getPawnAttacks(src, us) & state.bbs.forColor(them))[dst])
 					return false;
 			}
 			// forward move onto a piece
@@ -537,35 +590,125 @@ namespace stormphranj
 		return true;
 	}
 
+	auto Position::calcCheckers(const BoardState &state, Color us) -> Bitboard
+	{
+		const auto &bbs = state.bbs;
+
+		const auto king = state.king(us);
+		const auto them = oppColor(us);
+
+		Bitboard checkers{};
+
+		checkers |= bbs.pawns(them) & attacks::getPawnAttacks(king, us);
+		checkers |= bbs.alfils(them) & attacks::getAlfilAttacks(king);
+		checkers |= bbs.ferzes(them) & attacks::getFerzAttacks(king);
+		checkers |= bbs.knights(them) & attacks::getKnightAttacks(king);
+		checkers |= bbs.rooks(them) & attacks::getRookAttacks(king, bbs.occupancy());
+		checkers |= bbs.kings(them) & attacks::getKingAttacks(king);
+
+		return checkers;
+	}
+
+	auto Position::calcPinned(const BoardState &state, Color us) -> Bitboard
+	{
+		Bitboard pinned{};
+
+		const auto king = state.king(us);
+		const auto opponent = oppColor(us);
+
+		const auto &bbs = state.bbs;
+
+		const auto ourOcc = bbs.occupancy(us);
+		const auto oppOcc = bbs.occupancy(opponent);
+
+		auto potentialAttackers = attacks::getRookAttacks(king, oppOcc) & bbs.rooks(opponent);
+
+		while (potentialAttackers)
+		{
+			const auto potentialAttacker = potentialAttackers.popLowestSquare();
+			const auto maybePinned = ourOcc & orthoRayBetween(potentialAttacker, king);
+
+			if (maybePinned.one())
+				pinned |= maybePinned;
+		}
+
+		return pinned;
+	}
+
+	auto Position::calcThreats(const BoardState &state, Color us) -> Bitboard
+	{
+		const auto them = oppColor(us);
+
+		const auto &bbs = state.bbs;
+
+		Bitboard threats{};
+
+		const auto occ = bbs.occupancy();
+
+		threats |= attacks::getPawnSetAttacks(bbs.pawns(them), them);
+		threats |= attacks::getFerzSetAttacks(bbs.ferzes(them));
+
+		auto alfils = bbs.alfils(them);
+		while (alfils)
+		{
+			const auto alfil = alfils.popLowestSquare();
+			threats |= attacks::getAlfilAttacks(alfil);
+		}
+
+		auto knights = bbs.knights(them);
+		while (knights)
+		{
+			const auto knight = knights.popLowestSquare();
+			threats |= attacks::getKnightAttacks(knight);
+		}
+
+		auto rooks = bbs.rooks(them);
+		while (rooks)
+		{
+			const auto rook = rooks.popLowestSquare();
+			threats |= attacks::getRookAttacks(rook, occ);
+		}
+
+		threats |= attacks::getKingAttacks(state.king(them));
+
+		return threats;
+	}
+
 	// This does *not* check for pseudolegality, moves are assumed to be pseudolegal
 	auto Position::isLegal(Move move) const -> bool
 	{
+		SPJ_PROFILE_SCOPE(IsLegal);
+
 		assert(move != NullMove);
 
 		const auto us = toMove();
 		const auto them = oppColor(us);
 
 		const auto &state = currState();
-		const auto &bbs = state.boards.bbs();
+		const auto &bbs = state.bbs;
 
 		const auto src = move.src();
 		const auto dst = move.dst();
 
 		const auto king = state.king(us);
 
-		const auto moving = state.boards.pieceAt(src);
+		const auto moving = m_mailbox.pieceAt(src);
 
 		if (pieceType(moving) == PieceType::King)
 		{
 			const auto kinglessOcc = bbs.occupancy() ^ bbs.kings(us);
 
-			return !state.threats[move.dst()]
+			const auto threats = this->threats();
+
+			return !threats[move.dst()]
 				&& (attacks::getRookAttacks(dst, kinglessOcc) & bbs.rooks(them)).empty();
 		}
 
+		const auto pinned = this->pinned();
+
 		// multiple checks can only be evaded with a king move
 		if (state.checkers.multiple()
-			|| state.pinned[src] && !orthoRayIntersecting(src, dst)[king])
+			|| pinned[src] && !orthoRayIntersecting(src, dst)[king])
 			return false;
 
 		if (state.checkers.empty())
@@ -590,7 +733,7 @@ namespace stormphranj
 			return m_keys[m_keys.size() - d];
 		};
 
-		const auto occ = state.boards.bbs().occupancy();
+		const auto occ = state.bbs.occupancy();
 		const auto originalKey = state.key;
 
 		auto other = ~(originalKey ^ S(1));
@@ -621,9 +764,9 @@ namespace stormphranj
 				if (ply > d)
 					return true;
 
-				auto piece = state.boards.pieceAt(move.src());
+				auto piece = m_mailbox.pieceAt(move.src());
 				if (piece == Piece::None)
-					piece = state.boards.pieceAt(move.dst());
+					piece = m_mailbox.pieceAt(move.dst());
 
 				assert(piece != Piece::None);
 
@@ -637,6 +780,7 @@ namespace stormphranj
 	auto Position::toFen() const -> std::string
 	{
 		const auto &state = currState();
+		const auto boards = this->boards();
 
 		std::ostringstream fen{};
 
@@ -644,14 +788,14 @@ namespace stormphranj
 		{
 			for (i32 file = 0; file < 8; ++file)
 			{
-				if (state.boards.pieceAt(rank, file) == Piece::None)
+				if (boards.pieceAt(rank, file) == Piece::None)
 				{
 					u32 emptySquares = 1;
-					for (; file < 7 && state.boards.pieceAt(rank, file + 1) == Piece::None; ++file, ++emptySquares) {}
+					for (; file < 7 && boards.pieceAt(rank, file + 1) == Piece::None; ++file, ++emptySquares) {}
 
 					fen << static_cast<char>('0' + emptySquares);
 				}
-				else fen << pieceToChar(state.boards.pieceAt(rank, file));
+				else fen << pieceToChar(boards.pieceAt(rank, file));
 			}
 
 			if (rank > 0)
@@ -678,7 +822,12 @@ namespace stormphranj
 
 		auto &state = currState();
 
-		state.boards.setPiece(square, piece);
+		assert(m_mailbox.pieceAt(square) == Piece::None);
+
+		m_mailbox[square] = piece;
+
+		state.bbs.forPiece(pieceType(piece))[square] = true;
+		state.bbs.forColor(pieceColor(piece))[square] = true;
 
 		if constexpr (UpdateKey)
 		{
@@ -697,7 +846,12 @@ namespace stormphranj
 
 		auto &state = currState();
 
-		state.boards.removePiece(square, piece);
+		assert(m_mailbox.pieceAt(square) == piece);
+
+		m_mailbox[square] = Piece::None;
+
+		state.bbs.forPiece(pieceType(piece))[square] = false;
+		state.bbs.forColor(pieceColor(piece))[square] = false;
 
 		if constexpr (UpdateKey)
 		{
@@ -719,7 +873,13 @@ namespace stormphranj
 
 		auto &state = currState();
 
-		state.boards.movePiece(src, dst, piece);
+		m_mailbox[src] = Piece::None;
+		m_mailbox[dst] = piece;
+
+		const auto mask = Bitboard::fromSquare(src) ^ Bitboard::fromSquare(dst);
+
+		state.bbs.forPiece(pieceType(piece)) ^= mask;
+		state.bbs.forColor(pieceColor(piece)) ^= mask;
 
 		if (pieceType(piece) == PieceType::King)
 		{
@@ -745,13 +905,14 @@ namespace stormphranj
 
 		auto &state = currState();
 
-		const auto captured = state.boards.pieceAt(dst);
+		const auto captured = m_mailbox.pieceAt(dst);
 
 		if (captured != Piece::None)
 		{
 			assert(pieceType(captured) != PieceType::King);
 
-			state.boards.removePiece(dst, captured);
+			state.bbs.forPiece(pieceType(captured))[dst] = false;
+			state.bbs.forColor(pieceColor(captured))[dst] = false;
 
 			// NNUE update done below
 
@@ -762,7 +923,13 @@ namespace stormphranj
 			}
 		}
 
-		state.boards.movePiece(src, dst, piece);
+		m_mailbox[src] = Piece::None;
+		m_mailbox[dst] = piece;
+
+		const auto mask = Bitboard::fromSquare(src) ^ Bitboard::fromSquare(dst);
+
+		state.bbs.forPiece(pieceType(piece)) ^= mask;
+		state.bbs.forColor(pieceColor(piece)) ^= mask;
 
 		if (pieceType(piece) == PieceType::King)
 		{
@@ -809,13 +976,14 @@ namespace stormphranj
 
 		auto &state = currState();
 
-		const auto captured = state.boards.pieceAt(dst);
+		const auto captured = m_mailbox.pieceAt(dst);
 
 		if (captured != Piece::None)
 		{
 			assert(pieceType(captured) != PieceType::King);
 
-			state.boards.removePiece(dst, captured);
+			state.bbs.forPiece(pieceType(captured))[dst] = false;
+			state.bbs.forColor(pieceColor(captured))[dst] = false;
 
 			if constexpr (UpdateNnue)
 				nnueUpdates.pushSub(captured, dst);
@@ -824,7 +992,14 @@ namespace stormphranj
 				state.key ^= keys::pieceSquare(captured, dst);
 		}
 
-		state.boards.moveAndChangePiece(src, dst, pawn, PieceType::Ferz);
+		m_mailbox[src] = Piece::None;
+		m_mailbox[dst] = copyPieceColor(pawn, PieceType::Ferz);
+
+		state.bbs.forPiece(PieceType::Pawn)[src] = false;
+		state.bbs.forPiece(PieceType::Ferz)[dst] = true;
+
+		const auto mask = Bitboard::fromSquare(src) ^ Bitboard::fromSquare(dst);
+		state.bbs.forColor(pieceColor(pawn)) ^= mask;
 
 		if constexpr(UpdateNnue || UpdateKey)
 		{
@@ -847,7 +1022,7 @@ namespace stormphranj
 	{
 		auto &state = currState();
 
-		state.boards.regenFromBbs();
+		m_mailbox.regenFromBbs(state.bbs);
 		state.key = 0;
 
 		for (u32 rank = 0; rank < 8; ++rank)
@@ -855,7 +1030,7 @@ namespace stormphranj
 			for (u32 file = 0; file < 8; ++file)
 			{
 				const auto square = toSquare(rank, file);
-				if (const auto piece = state.boards.pieceAt(square); piece != Piece::None)
+				if (const auto piece = m_mailbox.pieceAt(square); piece != Piece::None)
 				{
 					if (pieceType(piece) == PieceType::King)
 						state.king(pieceColor(piece)) = square;
@@ -869,9 +1044,8 @@ namespace stormphranj
 		const auto colorKey = keys::color(toMove());
 		state.key ^= colorKey;
 
-		state.checkers = calcCheckers();
-		state.pinned = calcPinned();
-		state.threats = calcThreats();
+		state.checkers = calcCheckers(state, toMove());
+		state.dirty = BoardState::DirtyAll;
 	}
 
 #ifndef NDEBUG
@@ -918,6 +1092,12 @@ namespace stormphranj
 
 		out << std::dec;
 
+		if (m_mailbox != regened.m_mailbox)
+		{
+			out << "info string mailboxes do not match\n";
+			failed = true;
+		}
+
 #undef SPJ_CHECK_PIECES
 #undef SPJ_CHECK_PIECE
 #undef SPJ_CHECK
@@ -937,9 +1117,7 @@ namespace stormphranj
 		const auto src = squareFromString(move.substr(0, 2));
 		const auto dst = squareFromString(move.substr(2, 2));
 
-		const auto &state = currState();
-
-		const auto srcPiece = pieceType(state.boards.pieceAt(src));
+		const auto srcPiece = pieceType(m_mailbox.pieceAt(src));
 		const auto promoRank = relativeRank(toMove(), 7);
 
 		return (srcPiece == PieceType::Pawn && squareRank(dst) == promoRank)
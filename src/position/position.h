@@ -38,13 +38,16 @@ namespace stormphranj
 {
 	struct BoardState
 	{
-		PositionBoards boards{};
+		BitboardSet bbs{};
 
 		u64 key{};
 
 		Bitboard checkers{};
-		Bitboard pinned{};
-		Bitboard threats{};
+
+		// derived from the board, and only computed when first requested
+		// through Position - see the dirty flags below
+		mutable Bitboard pinned{};
+		mutable Bitboard threats{};
 
 		Move lastMove{NullMove};
 
@@ -52,6 +55,16 @@ namespace stormphranj
 
 		std::array<Square, 2> kings{Square::None, Square::None};
 
+		// piece captured by the move that led to this state, for restoring the mailbox
+		Piece captured{Piece::None};
+
+		static constexpr u8 DirtyPinned = 1 << 0;
+		static constexpr u8 DirtyThreats = 1 << 1;
+
+		static constexpr u8 DirtyAll = DirtyPinned | DirtyThreats;
+
+		mutable u8 dirty{DirtyAll};
+
 		[[nodiscard]] inline auto blackKing() const
 		{
 			return kings[0];
@@ -73,7 +86,7 @@ namespace stormphranj
 		}
 	};
 
-	static_assert(sizeof(BoardState) == 168);
+	static_assert(sizeof(BoardState) == 104);
 
 	[[nodiscard]] inline auto squareToString(Square square)
 	{
@@ -110,7 +123,12 @@ namespace stormphranj
 		Position(Position &&) = default;
 
 		auto resetToStarting() -> void;
-		auto resetFromFen(const std::string &fen) -> bool;
+		// Prints the reason to stderr on failure, unless quiet
+		auto resetFromFen(const std::string &fen, bool quiet = false) -> bool;
+		// For bulk loading of positions that have already been validated once, e.g.
+		// datagen output. Only checks that the position is sane enough to search or
+		// play moves in, and does not print anything on failure
+		auto resetFromBbs(const BitboardSet &bbs, Color stm, u32 halfmove, u32 fullmove) -> bool;
 
 		auto copyStateFrom(const Position &other) -> void;
 
@@ -143,8 +161,8 @@ namespace stormphranj
 		[[nodiscard]] inline auto currState() const -> const auto & { return m_states.back(); }
 
 	public:
-		[[nodiscard]] inline auto boards() const -> const auto & { return currState().boards; }
-		[[nodiscard]] inline auto bbs() const -> const auto & { return currState().boards.bbs(); }
+		[[nodiscard]] inline auto boards() const { return PositionBoards{currState().bbs, m_mailbox}; }
+		[[nodiscard]] inline auto bbs() const -> const auto & { return currState().bbs; }
 
 		[[nodiscard]] inline auto toMove() const
 		{
@@ -167,10 +185,10 @@ namespace stormphranj
 
 			const auto &state = currState();
 
-			const auto moving = state.boards.pieceAt(move.src());
+			const auto moving = m_mailbox.pieceAt(move.src());
 			assert(moving != Piece::None);
 
-			const auto captured = state.boards.pieceAt(move.dst());
+			const auto captured = m_mailbox.pieceAt(move.dst());
 
 			auto key = state.key;
 
@@ -256,38 +274,28 @@ namespace stormphranj
 			if constexpr (ThreatShortcut)
 			{
 				if (attacker != toMove)
-					return state.threats[square];
+				{
+					const auto threats = threatsOf(state, toMove);
+					return threats[square];
+				}
 			}
 
-			const auto &bbs = state.boards.bbs();
+			const auto &bbs = state.bbs;
 
-			const auto occ = bbs.occupancy();
+			const auto theirs = bbs.forColor(attacker);
 
-			if (const auto knights = bbs.knights(attacker);
-				!(knights & attacks::getKnightAttacks(square)).empty())
-				return true;
-
-			if (const auto ferzes = bbs.ferzes(attacker);
-				!(ferzes & attacks::getFerzAttacks(square)).empty())
-				return true;
-
-			if (const auto pawns = bbs.pawns(attacker);
-				!(pawns & attacks::getPawnAttacks(square, oppColor(attacker))).empty())
-				return true;
-
-			if (const auto alfils = bbs.alfils(attacker);
-				!(alfils & attacks::getAlfilAttacks(square)).empty())
-				return true;
+			// all leapers at once, to avoid a branch per piece type
+			const auto leapers = (bbs.knights() & attacks::getKnightAttacks(square))
+				| (bbs.ferzes() & attacks::getFerzAttacks(square))
+				| (bbs.alfils() & attacks::getAlfilAttacks(square))
+				| (bbs.kings() & attacks::getKingAttacks(square))
+				| (bbs.pawns() & attacks::getPawnAttacks(square, oppColor(attacker)));
 
-			if (const auto kings = bbs.kings(attacker);
-				!(kings & attacks::getKingAttacks(square)).empty())
+			if (!(leapers & theirs).empty())
 				return true;
 
-			if (const auto rooks = bbs.rooks(attacker);
-				!(rooks & attacks::getRookAttacks(square, occ)).empty())
-				return true;
-
-			return false;
+			const auto rooks = bbs.rooks() & theirs;
+			return !(rooks & attacks::getRookAttacks(square, bbs.occupancy())).empty();
 		}
 
 		template <bool ThreatShortcut = true>
@@ -304,7 +312,7 @@ namespace stormphranj
 			assert(attacker != Color::None);
 
 			if (attacker == opponent())
-				return !(squares & currState().threats).empty();
+				return !(squares & threats()).empty();
 
 			while (squares)
 			{
@@ -349,8 +357,11 @@ namespace stormphranj
 		}
 
 		[[nodiscard]] inline auto checkers() const { return currState().checkers; }
-		[[nodiscard]] inline auto pinned() const { return currState().pinned; }
-		[[nodiscard]] inline auto threats() const { return currState().threats; }
+		[[nodiscard]] inline auto pinned() const -> Bitboard { return pinnedOf(currState(), toMove()); }
+		[[nodiscard]] inline auto threats() const -> Bitboard { return threatsOf(currState(), toMove()); }
+
+		// always computed from scratch, for benchmarking
+		[[nodiscard]] inline auto calcThreats() const -> Bitboard { return calcThreats(currState(), toMove()); }
 
 		[[nodiscard]] auto hasCycle(i32 ply) const -> bool;
 
@@ -431,7 +442,8 @@ namespace stormphranj
 			const auto &theirState = other.m_states.back();
 
 			// every other field is a function of these
-			return ourState.boards == theirState.boards
+			return ourState.bbs == theirState.bbs
+				&& m_mailbox == other.m_mailbox
 				&& ourState.halfmove == theirState.halfmove
 				&& m_fullmove == other.m_fullmove;
 		}
@@ -441,8 +453,8 @@ namespace stormphranj
 			return *this == other
 				&& currState().kings == other.m_states.back().kings
 				&& currState().checkers == other.m_states.back().checkers
-				&& currState().pinned == other.m_states.back().pinned
-				&& currState().threats == other.m_states.back().threats
+				&& pinned() == other.pinned()
+				&& threats() == other.threats()
 				&& currState().key == other.m_states.back().key;
 		}
 
@@ -480,97 +492,38 @@ namespace stormphranj
 		template <bool UpdateKeys = true, bool UpdateNnue = true>
 		auto promotePawn(Piece pawn, Square src, Square dst, eval::NnueUpdates &nnueUpdates) -> Piece;
 
-		[[nodiscard]] inline auto calcCheckers() const
-		{
-			const auto color = toMove();
-			const auto &state = currState();
-
-			return attackersTo(state.king(color), oppColor(color));
-		}
-
-		[[nodiscard]] inline auto calcPinned() const
+		[[nodiscard]] static inline auto pinnedOf(const BoardState &state, Color us) -> Bitboard
 		{
-			const auto color = toMove();
-			const auto &state = currState();
-
-			Bitboard pinned{};
-
-			const auto king = state.king(color);
-			const auto opponent = oppColor(color);
-
-			const auto &bbs = state.boards.bbs();
-
-			const auto ourOcc = bbs.occupancy(color);
-			const auto oppOcc = bbs.occupancy(opponent);
-
-			auto potentialAttackers = attacks::getRookAttacks(king, oppOcc) & bbs.rooks(opponent);
-
-			while (potentialAttackers)
+			if (state.dirty & BoardState::DirtyPinned)
 			{
-				const auto potentialAttacker = potentialAttackers.popLowestSquare();
-				const auto maybePinned = ourOcc & orthoRayBetween(potentialAttacker, king);
-
-				if (maybePinned.one())
-					pinned |= maybePinned;
+				state.pinned = calcPinned(state, us);
+				state.dirty &= ~BoardState::DirtyPinned;
 			}
 
-			return pinned;
+			return state.pinned;
 		}
 
-		[[nodiscard]] inline auto calcThreats() const
+		[[nodiscard]] static inline auto threatsOf(const BoardState &state, Color us) -> Bitboard
 		{
-			const auto us = toMove();
-			const auto them = oppColor(us);
-
-			const auto &state = currState();
-			const auto &bbs = state.boards.bbs();
-
-			Bitboard threats{};
-
-			const auto occ = bbs.occupancy();
-
-			auto alfils = bbs.alfils(them);
-			while (alfils)
+			if (state.dirty & BoardState::DirtyThreats)
 			{
-				const auto alfil = alfils.popLowestSquare();
-				threats |= attacks::getAlfilAttacks(alfil);
+				state.threats = calcThreats(state, us);
+				state.dirty &= ~BoardState::DirtyThreats;
 			}
 
-			auto ferzes = bbs.ferzes(them);
-			while (ferzes)
-			{
-				const auto ferz = ferzes.popLowestSquare();
-				threats |= attacks::getFerzAttacks(ferz);
-			}
-
-			auto knights = bbs.knights(them);
-			while (knights)
-			{
-				const auto knight = knights.popLowestSquare();
-				threats |= attacks::getKnightAttacks(knight);
-			}
-
-			auto rooks = bbs.rooks(them);
-			while (rooks)
-			{
-				const auto rook = rooks.popLowestSquare();
-				threats |= attacks::getRookAttacks(rook, occ);
-			}
-
-			const auto pawns = bbs.pawns(them);
-			if (them == Color::Black)
-				threats |= pawns.shiftDownLeft() | pawns.shiftDownRight();
-			else threats |= pawns.shiftUpLeft() | pawns.shiftUpRight();
-
-			threats |= attacks::getKingAttacks(state.king(them));
-
-			return threats;
+			return state.threats;
 		}
 
+		[[nodiscard]] static auto calcCheckers(const BoardState &state, Color us) -> Bitboard;
+		[[nodiscard]] static auto calcPinned(const BoardState &state, Color us) -> Bitboard;
+		[[nodiscard]] static auto calcThreats(const BoardState &state, Color us) -> Bitboard;
+
 		bool m_blackToMove{};
 
 		u32 m_fullmove{1};
 
+		Mailbox m_mailbox{};
+
 		std::vector<BoardState> m_states{};
 		std::vector<u64> m_keys{};
 	};
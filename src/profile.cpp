@@ -0,0 +1,128 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "profile.h"
+
+#if SPJ_CYCLE_PROFILE
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#endif
+
+namespace stormphranj::profile
+{
+#if SPJ_CYCLE_PROFILE
+	namespace
+	{
+		constexpr auto ScopeNames = std::array {
+			std::string_view{"movegen"},
+			std::string_view{"nnue update"},
+			std::string_view{"evaluate"},
+			std::string_view{"tt probe"},
+			std::string_view{"tt put"},
+			std::string_view{"see"},
+			std::string_view{"isLegal"},
+		};
+
+		static_assert(ScopeNames.size() == static_cast<usize>(Scope::Count));
+
+		std::mutex s_registryMutex{};
+		std::vector<std::unique_ptr<ScopeCounters>> s_registry{};
+
+		u64 s_startCycles{};
+	}
+
+	auto registerThread() -> ScopeCounters *
+	{
+		const std::unique_lock lock{s_registryMutex};
+		return s_registry.emplace_back(std::make_unique<ScopeCounters>()).get();
+	}
+
+	auto reset() -> void
+	{
+		const std::unique_lock lock{s_registryMutex};
+
+		for (auto &counters : s_registry)
+		{
+			*counters = ScopeCounters{};
+		}
+
+		s_startCycles = readTsc();
+	}
+
+	auto print() -> void
+	{
+		const auto elapsed = readTsc() - s_startCycles;
+
+		ScopeCounters total{};
+		usize threads{};
+
+		{
+			const std::unique_lock lock{s_registryMutex};
+
+			for (const auto &counters : s_registry)
+			{
+				bool used = false;
+
+				for (usize scope = 0; scope < static_cast<usize>(Scope::Count); ++scope)
+				{
+					total.calls[scope] += counters->calls[scope];
+					total.cycles[scope] += counters->cycles[scope];
+
+					used |= counters->calls[scope] > 0;
+				}
+
+				threads += used;
+			}
+		}
+
+		const auto totalCycles = static_cast<f64>(elapsed) * static_cast<f64>(std::max<usize>(threads, 1));
+
+		const auto flags = std::cout.flags();
+		const auto precision = std::cout.precision();
+
+		std::cout << "\ncycle profile over " << threads << " thread(s), " << elapsed << " cycles elapsed\n";
+		std::cout << std::setw(12) << "scope" << std::setw(14) << "calls"
+			<< std::setw(16) << "cycles/call" << std::setw(10) << "share" << '\n';
+
+		std::cout << std::fixed << std::setprecision(1);
+
+		for (usize scope = 0; scope < static_cast<usize>(Scope::Count); ++scope)
+		{
+			const auto calls = total.calls[scope];
+			const auto cycles = static_cast<f64>(total.cycles[scope]);
+
+			std::cout << std::setw(12) << ScopeNames[scope] << std::setw(14) << calls
+				<< std::setw(16) << (calls == 0 ? 0.0 : cycles / static_cast<f64>(calls))
+				<< std::setw(9) << (cycles * 100.0 / totalCycles) << "%\n";
+		}
+
+		std::cout << std::flush;
+
+		std::cout.flags(flags);
+		std::cout.precision(precision);
+	}
+#else
+	auto reset() -> void {}
+	auto print() -> void {}
+#endif
+}
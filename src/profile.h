@@ -0,0 +1,108 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+
+#include "arch.h"
+
+#if SPJ_CYCLE_PROFILE
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace stormphranj::profile
+{
+	// Cycle counts of hot call sites, compiled in with SPJ_CYCLE_PROFILE
+	// Timings are inclusive - see calls made while scoring moves are also counted under movegen
+
+	enum class Scope : u32
+	{
+		Movegen = 0,
+		NnueUpdate,
+		Evaluate,
+		TtProbe,
+		TtPut,
+		See,
+		IsLegal,
+		Count,
+	};
+
+#if SPJ_CYCLE_PROFILE
+	struct alignas(SPJ_CACHE_LINE_SIZE) ScopeCounters
+	{
+		std::array<u64, static_cast<usize>(Scope::Count)> calls{};
+		std::array<u64, static_cast<usize>(Scope::Count)> cycles{};
+	};
+
+	// registers a new set of counters for the calling thread, never freed
+	auto registerThread() -> ScopeCounters *;
+
+	inline thread_local ScopeCounters *t_counters{};
+
+	[[nodiscard]] inline auto readTsc() -> u64
+	{
+		return __rdtsc();
+	}
+
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Scope scope)
+			: m_scope{scope},
+			  m_start{readTsc()} {}
+
+		~ScopedTimer()
+		{
+			const auto end = readTsc();
+
+			if (!t_counters) [[unlikely]]
+				t_counters = registerThread();
+
+			++t_counters->calls[static_cast<usize>(m_scope)];
+			t_counters->cycles[static_cast<usize>(m_scope)] += end - m_start;
+		}
+
+		ScopedTimer(const ScopedTimer &) = delete;
+		ScopedTimer(ScopedTimer &&) = delete;
+
+	private:
+		Scope m_scope;
+		u64 m_start;
+	};
+
+	#define SPJ_PROFILE_SCOPE(S) const ::stormphranj::profile::ScopedTimer spjProfileScope \
+		{::stormphranj::profile::Scope::S}
+#else
+	#define SPJ_PROFILE_SCOPE(S)
+#endif
+
+	// zeroes every thread's counters and starts the reference clock
+	// must not be called while searching, no-op when disabled
+	auto reset() -> void;
+
+	// prints cycles per call, and share of the cycles elapsed since
+	// the last reset summed over all threads, no-op when disabled
+	auto print() -> void;
+}
@@ -19,6 +19,7 @@
 #include "search.h"
 
 #include <iostream>
+#include <iomanip>
 #include <cmath>
 #include <cassert>
 
@@ -35,10 +36,24 @@ namespace stormphranj::search
 	{
 		constexpr f64 MinReportDelay = 1.0;
 
+		constexpr i32 MinAbdadaDepth = 4;
+
 		inline auto drawScore(usize nodes)
 		{
 			return 2 - static_cast<Score>(nodes % 4);
 		}
+
+		inline auto rawStaticEval(ThreadData &thread, const ProbedTTableEntry &ttEntry) -> Score
+		{
+			if (ttEntry.staticEval != NoTtStaticEval)
+			{
+				++thread.search.ttEvals;
+				return ttEntry.staticEval;
+			}
+
+			++thread.search.nnueEvals;
+			return eval::rawEval(thread.pos, thread.nnueState);
+		}
 	}
 
 	Searcher::Searcher(std::optional<usize> ttSize)
@@ -64,8 +79,8 @@ namespace stormphranj::search
 		}
 	}
 
-	auto Searcher::startSearch(const Position &pos, i32 maxDepth,
-		std::unique_ptr<limit::ISearchLimiter> limiter) -> void
+	auto Searcher::startSearch(const Position &pos, i32 maxDepth, std::unique_ptr<limit::ISearchLimiter> limiter,
+		std::span<const Move> searchMoves, bool ponder) -> void
 	{
 		if (!m_limiter && !limiter)
 		{
@@ -79,6 +94,19 @@ namespace stormphranj::search
 		ScoredMoveList rootMoves{};
 		generateAll(rootMoves, pos);
 
+		if (!searchMoves.empty())
+		{
+			ScoredMoveList filtered{};
+
+			for (const auto &move : rootMoves)
+			{
+				if (std::ranges::find(searchMoves, move.move) != searchMoves.end())
+					filtered.push(move);
+			}
+
+			rootMoves = filtered;
+		}
+
 		m_resetBarrier.arriveAndWait();
 
 		if (limiter)
@@ -93,13 +121,20 @@ namespace stormphranj::search
 		{
 			thread.maxDepth = maxDepth;
 			thread.search = SearchData{};
+			thread.stats = {};
 			thread.pos = pos;
 
-			thread.rootMoves() = rootMoves;
+			thread.setRootMoves(rootMoves);
 
 			thread.nnueState.reset(thread.pos.bbs(), thread.pos.blackKing(), thread.pos.whiteKing());
 		}
 
+		m_pendingLimiter.reset();
+		m_limiterPending.store(false, std::memory_order::seq_cst);
+		m_pondering.store(ponder, std::memory_order::seq_cst);
+
+		m_totalNodes.store(0, std::memory_order::seq_cst);
+
 		m_stop.store(false, std::memory_order::seq_cst);
 		m_runningThreads.store(static_cast<i32>(m_threads.size()));
 
@@ -110,7 +145,14 @@ namespace stormphranj::search
 
 	auto Searcher::stop() -> void
 	{
-		m_stop.store(true, std::memory_order::relaxed);
+		// under the ponder mutex, in case the main thread finished
+		// pondering early and is waiting to send bestmove
+		{
+			std::unique_lock lock{m_ponderMutex};
+			m_stop.store(true, std::memory_order::relaxed);
+		}
+
+		m_ponderSignal.notify_all();
 
 		// safe, always runs from uci thread
 		if (m_runningThreads.load() > 0)
@@ -123,10 +165,42 @@ namespace stormphranj::search
 		}
 	}
 
+	auto Searcher::ponderhit(std::unique_ptr<limit::ISearchLimiter> limiter) -> void
+	{
+		{
+			std::unique_lock lock{m_ponderMutex};
+
+			m_pendingLimiter = std::move(limiter);
+			m_limiterPending.store(true, std::memory_order::release);
+
+			m_pondering.store(false, std::memory_order::release);
+		}
+
+		m_ponderSignal.notify_all();
+	}
+
+	auto Searcher::installPendingLimiter() -> void
+	{
+		// only ever called from the main search thread
+		std::unique_lock lock{m_ponderMutex};
+
+		if (m_pendingLimiter)
+			m_limiter = std::move(m_pendingLimiter);
+
+		m_limiterPending.store(false, std::memory_order::relaxed);
+	}
+
+	auto Searcher::flushNodes() -> void
+	{
+		m_totalNodes.fetch_add(NodeFlushInterval, std::memory_order::relaxed);
+	}
+
 	auto Searcher::runDatagenSearch(ThreadData &thread) -> std::pair<Score, Score>
 	{
-		thread.rootMoves().clear();
-		generateAll(thread.rootMoves(), thread.pos);
+		ScoredMoveList rootMoves{};
+		generateAll(rootMoves, thread.pos);
+
+		thread.setRootMoves(rootMoves);
 
 		m_stop.store(false, std::memory_order::seq_cst);
 
@@ -152,8 +226,10 @@ namespace stormphranj::search
 
 		thread->nnueState.reset(thread->pos.bbs(), thread->pos.blackKing(), thread->pos.whiteKing());
 
-		thread->rootMoves().clear();
-		generateAll(thread->rootMoves(), thread->pos);
+		ScoredMoveList rootMoves{};
+		generateAll(rootMoves, thread->pos);
+
+		thread->setRootMoves(rootMoves);
 
 		m_stop.store(false, std::memory_order::seq_cst);
 
@@ -164,6 +240,7 @@ namespace stormphranj::search
 		const auto time = util::g_timer.time() - start;
 
 		data.search = thread->search;
+		data.stats = thread->stats;
 		data.time = time;
 	}
 
@@ -237,6 +314,8 @@ namespace stormphranj::search
 		auto score = -ScoreInf;
 		PvList pv{};
 
+		const auto multiPv = std::max(std::min(m_multiPv, static_cast<u32>(thread.rootMoves().size())), 1U);
+
 		const auto startTime = reportAndUpdate ? util::g_timer.time() : 0.0;
 		const auto startDepth = 1 + static_cast<i32>(thread.id) % 16;
 
@@ -244,6 +323,9 @@ namespace stormphranj::search
 
 		bool hitSoftTimeout = false;
 
+		// whether the current pv has been sent in an info line yet
+		bool pvReported = false;
+
 		for (i32 depth = startDepth;
 			depth <= thread.maxDepth
 				&& !(hitSoftTimeout = shouldStop(searchData, thread.isMainThread(), true));
@@ -252,76 +334,142 @@ namespace stormphranj::search
 			searchData.depth = depth;
 			searchData.seldepth = 0;
 
-			bool reportThisIter = reportAndUpdate;
-
-			if (depth < minAspDepth())
+			for (auto &rootMove : thread.rootMoves())
 			{
-				const auto newScore = search<true>(thread, thread.rootPv, depth, 0, 0, -ScoreInf, ScoreInf, false);
-
-				depthCompleted = depth;
+				rootMove.previousScore = rootMove.score;
+				rootMove.nodes = 0;
+			}
 
-				if (depth > 1 && m_stop.load(std::memory_order::relaxed) || thread.rootPv.length == 0)
-					break;
+			bool reportThisIter = reportAndUpdate;
+			bool abort = false;
 
-				score = newScore;
-				pv.copyFrom(thread.rootPv);
-			}
-			else
+			// Each pv line is searched with the moves of the lines before it excluded
+			for (thread.pvIdx = 0; thread.pvIdx < multiPv; ++thread.pvIdx)
 			{
-				auto aspDepth = depth;
+				const bool firstLine = thread.pvIdx == 0;
 
-				auto delta = initialAspWindow();
+				// the first line is centred on the best line's score from the last iteration
+				Score otherLineScore = thread.rootMoves()[thread.pvIdx].previousScore;
+				auto &lineScore = firstLine ? score : otherLineScore;
 
-				auto alpha = std::max(score - delta, -ScoreInf);
-				auto beta  = std::min(score + delta,  ScoreInf);
+				bool lineCompleted = false;
 
-				while (!shouldStop(searchData, thread.isMainThread(), false))
+				if (depth < minAspDepth() || !firstLine && lineScore == -ScoreInf)
 				{
-					aspDepth = std::max(aspDepth, depth - maxAspReduction());
+					const auto newScore = search<true>(thread, thread.rootPv, depth, 0, 0, -ScoreInf, ScoreInf, false);
 
-					const auto newScore = search<true>(thread, thread.rootPv, aspDepth, 0, 0, alpha, beta, false);
+					if (firstLine)
+						depthCompleted = depth;
 
-					const bool stop = m_stop.load(std::memory_order::relaxed);
-					if (stop || thread.rootPv.length == 0)
+					if (depth > 1 && m_stop.load(std::memory_order::relaxed) || thread.rootPv.length == 0)
 					{
-						reportThisIter &= !stop;
+						abort = true;
 						break;
 					}
 
-					score = newScore;
+					lineScore = newScore;
+					lineCompleted = true;
 
-					if (reportAndUpdate && (score <= alpha || score >= beta))
-					{
-						const auto time = util::g_timer.time() - startTime;
-						if (time > MinReportDelay)
-							report(thread, thread.rootPv, thread.search.depth, time, score, alpha, beta);
-					}
+					if (firstLine)
+						pv.copyFrom(thread.rootPv);
+				}
+				else
+				{
+					auto aspDepth = depth;
 
-					delta += delta * aspWideningFactor() / 16;
+					auto delta = initialAspWindow();
 
-					if (delta > maxAspWindow())
-						delta = ScoreInf;
+					auto alpha = std::max(lineScore - delta, -ScoreInf);
+					auto beta  = std::min(lineScore + delta,  ScoreInf);
 
-					if (score >= beta)
+					while (!shouldStop(searchData, thread.isMainThread(), false))
 					{
-						beta = std::min(beta + delta, ScoreInf);
-						--aspDepth;
+						aspDepth = std::max(aspDepth, depth - maxAspReduction());
+
+						const auto newScore = search<true>(thread, thread.rootPv, aspDepth, 0, 0, alpha, beta, false);
+
+						const bool stop = m_stop.load(std::memory_order::relaxed);
+						if (stop || thread.rootPv.length == 0)
+						{
+							reportThisIter &= !stop;
+							break;
+						}
+
+						lineScore = newScore;
+
+						if (reportAndUpdate && (lineScore <= alpha || lineScore >= beta))
+						{
+							const auto time = util::g_timer.time() - startTime;
+							if (time > MinReportDelay)
+								report(thread, thread.rootPv, thread.search.depth,
+									time, lineScore, alpha, beta, thread.pvIdx + 1);
+						}
+
+						delta += delta * aspWideningFactor() / 16;
+
+						if (delta > maxAspWindow())
+							delta = ScoreInf;
+
+						if (lineScore >= beta)
+						{
+							beta = std::min(beta + delta, ScoreInf);
+							--aspDepth;
+						}
+						else if (lineScore <= alpha)
+						{
+							beta = (alpha + beta) / 2;
+							alpha = std::max(alpha - delta, -ScoreInf);
+							aspDepth = depth;
+						}
+						else
+						{
+							if (firstLine)
+							{
+								pv.copyFrom(thread.rootPv);
+								depthCompleted = depth;
+							}
+
+							lineCompleted = true;
+							break;
+						}
 					}
-					else if (score <= alpha)
+				}
+
+				if (!lineCompleted)
+					break;
+
+				// moves that failed low are ordered by the effort it took to refute them
+				std::stable_sort(thread.rootMoves().begin() + thread.pvIdx, thread.rootMoves().end(),
+					[](const RootMove &a, const RootMove &b)
 					{
-						beta = (alpha + beta) / 2;
-						alpha = std::max(alpha - delta, -ScoreInf);
-						aspDepth = depth;
-					}
-					else
+						if (a.score != b.score)
+							return a.score > b.score;
+						return a.nodes > b.nodes;
+					});
+
+				// a later line can score above an earlier one, keep the finished lines in rank order
+				std::stable_sort(thread.rootMoves().begin(), thread.rootMoves().begin() + thread.pvIdx + 1,
+					[](const RootMove &a, const RootMove &b)
 					{
-						pv.copyFrom(thread.rootPv);
-						depthCompleted = depth;
-						break;
-					}
-				}
+						return a.score > b.score;
+					});
+
+				// bestmove and time management follow the best line, which need not be the first one searched
+				const auto &bestRootMove = thread.rootMoves()[0];
+
+				pv.copyFrom(bestRootMove.pv);
+				score = bestRootMove.score;
+
+				pvReported = false;
+
+				thread.orderRootMoves();
 			}
 
+			searchData.completedDepth = depthCompleted;
+
+			if (abort)
+				break;
+
 			if (reportAndUpdate)
 				m_limiter->update(thread.search, pv.moves[0], thread.search.nodes);
 
@@ -331,7 +479,15 @@ namespace stormphranj::search
 					pv.copyFrom(thread.rootPv);
 
 				if (pv.length > 0)
-					report(thread, pv, searchData.depth, util::g_timer.time() - startTime, score, -ScoreInf, ScoreInf);
+				{
+					const auto time = util::g_timer.time() - startTime;
+
+					reportLines(thread, pv, searchData.depth, time, score);
+					pvReported = true;
+
+					if (m_reportThreadStats)
+						reportThreadStats(time);
+				}
 				else
 				{
 					std::cout << "info string no legal moves" << std::endl;
@@ -342,18 +498,45 @@ namespace stormphranj::search
 
 		if (reportAndUpdate)
 		{
+			// bestmove must not be sent before ponderhit or stop
+			if (m_pondering.load(std::memory_order::acquire))
+			{
+				std::unique_lock lock{m_ponderMutex};
+				m_ponderSignal.wait(lock, [this]
+				{
+					return !m_pondering.load(std::memory_order::relaxed)
+						|| m_stop.load(std::memory_order::relaxed);
+				});
+			}
+
 			if (mainSearchThread)
 				m_searchMutex.lock();
 
 			if (pv.length > 0)
 			{
-				if (!hitSoftTimeout || !m_limiter->stopped())
-					report(thread, pv, depthCompleted, util::g_timer.time() - startTime, score, -ScoreInf, ScoreInf);
-				std::cout << "bestmove " << uci::moveToString(pv.moves[0]) << std::endl;
+				const auto time = util::g_timer.time() - startTime;
+
+				// the last iteration has already been reported if it completed, unless a
+				// later multipv line was stopped after an earlier one had changed the pv
+				if (!hitSoftTimeout || !m_limiter->stopped() || !pvReported)
+					reportLines(thread, pv, depthCompleted, time, score);
+
+				if (m_reportThreadStats)
+					reportThreadStats(time);
+
+				std::cout << "bestmove " << uci::moveToString(pv.moves[0]);
+
+				if (pv.length > 1)
+					std::cout << " ponder " << uci::moveToString(pv.moves[1]);
+
+				std::cout << std::endl;
 			}
 			else std::cout << "info string no legal moves" << std::endl;
 		}
 
+		// after reporting, which adds the main thread's unflushed nodes itself
+		m_totalNodes.fetch_add(searchData.nodes % NodeFlushInterval, std::memory_order::relaxed);
+
 		if (mainSearchThread)
 		{
 			--m_runningThreads;
@@ -444,12 +627,18 @@ namespace stormphranj::search
 		{
 			m_ttable.probe(ttEntry, pos.key(), ply);
 
+			++thread.search.ttProbes;
+			thread.search.ttHits += ttEntry.type != EntryType::None;
+
 			if (!pvNode
 				&& ttEntry.depth >= depth
 				&& (ttEntry.type == EntryType::Exact
 					|| ttEntry.type == EntryType::Alpha && ttEntry.score <= alpha
 					|| ttEntry.type == EntryType::Beta  && ttEntry.score >= beta))
+			{
+				stats::inc(thread.stats, stats::Counter::TtCutoff, depth);
 				return ttEntry.score;
+			}
 
 			if (ttEntry.move && pos.isPseudolegal(ttEntry.move))
 				ttMove = ttEntry.move;
@@ -469,6 +658,8 @@ namespace stormphranj::search
 		const bool ttHit = ttEntry.type != EntryType::None;
 		const bool ttMoveNoisy = ttMove && pos.isNoisy(ttMove);
 
+		Score rawEval = NoTtStaticEval;
+
 		// we already have the static eval in a singularity search
 		if (!stack.excluded)
 		{
@@ -476,7 +667,8 @@ namespace stormphranj::search
 				stack.eval = stack.staticEval = -ScoreInf;
 			else
 			{
-				stack.staticEval = eval::staticEval(pos, thread.nnueState, m_contempt);
+				rawEval = rawStaticEval(thread, ttEntry);
+				stack.staticEval = eval::adjustEval(pos, m_contempt, rawEval);
 				stack.eval = (ttEntry.type == EntryType::Exact
 						|| ttEntry.type == EntryType::Alpha && ttEntry.score < stack.staticEval
 						|| ttEntry.type == EntryType::Beta  && ttEntry.score > stack.staticEval)
@@ -488,6 +680,7 @@ namespace stormphranj::search
 		thread.stack[ply + 2].killer = NullMove;
 
 		thread.prevMoves[ply] = {};
+		stack.contEntry = nullptr;
 
 		const bool improving = [&]
 		{
@@ -509,7 +702,10 @@ namespace stormphranj::search
 				&& stack.eval >= beta
 					+ depth * (improving ? rfpMarginImproving() : rfpMarginNonImproving())
 					+ thread.stack[ply - 1].history / rfpHistoryMargin())
+			{
+				stats::inc(thread.stats, stats::Counter::Rfp, depth);
 				return (stack.eval + beta) / 2;
+			}
 
 			// Nullmove pruning (NMP)
 			// If static eval is above beta, and zugzwang is unlikely
@@ -546,7 +742,10 @@ namespace stormphranj::search
 				if (score >= beta)
 				{
 					if (depth < minNmpVerifDepth() || thread.minNmpPly > 0)
+					{
+						stats::inc(thread.stats, stats::Counter::Nmp, depth);
 						return score > ScoreWin ? beta : score;
+					}
 
 					// At higher depths, disable NMP for a certain number of plies
 					// and do a reduced-depth verification search. This is not for
@@ -559,7 +758,10 @@ namespace stormphranj::search
 					thread.minNmpPly = 0;
 
 					if (verifScore >= beta)
+					{
+						stats::inc(thread.stats, stats::Counter::Nmp, depth);
 						return verifScore;
+					}
 				}
 			}
 		}
@@ -581,8 +783,11 @@ namespace stormphranj::search
 
 		auto entryType = EntryType::Alpha;
 
+		const auto prevMove = ply > 0 ? thread.prevMoves[ply - 1] : HistoryMove{};
+		const auto continuations = thread.continuations(ply);
+
 		MoveGenerator<RootNode> generator{pos, stack.killer, moveStack.movegenData,
-			ttMove, ply, thread.prevMoves, &thread.history};
+			ttMove, prevMove, continuations, &thread.history};
 
 		u32 legalMoves = 0;
 
@@ -593,6 +798,14 @@ namespace stormphranj::search
 			if (move == stack.excluded)
 				continue;
 
+			// in multipv, the moves of earlier pv lines are excluded from the root
+			if constexpr (RootNode)
+			{
+				if (std::any_of(thread.rootMoves().begin(), thread.rootMoves().begin() + thread.pvIdx,
+					[move](const auto &rootMove) { return rootMove.move == move; }))
+					continue;
+			}
+
 			stack.history = history;
 
 			const auto prevNodes = thread.search.nodes;
@@ -620,7 +833,10 @@ namespace stormphranj::search
 					if (!pvNode
 						&& depth <= maxLmpDepth()
 						&& legalMoves >= lmpMinMovesBase() + lmrDepth * lmrDepth / (improving ? 1 : 2))
+					{
+						stats::inc(thread.stats, stats::Counter::Lmp, depth);
 						break;
+					}
 
 					// Futility pruning (FP)
 					// At this point, alpha is so far above static eval that it is
@@ -628,25 +844,32 @@ namespace stormphranj::search
 					if (depth <= maxFpDepth()
 						&& alpha < ScoreWin
 						&& stack.eval + fpMargin() + lmrDepth * fpScale() <= alpha)
+					{
+						stats::inc(thread.stats, stats::Counter::Fp, depth);
 						break;
+					}
 				}
 
 				// SEE pruning
 				// If this move loses a depth-dependent amount of material, just don't bother searching it
 				if (depth <= maxSeePruningDepth()
 					&& !see::see(pos, move, depth * (noisy ? noisySeeThreshold() : quietSeeThreshold())))
+				{
+					stats::inc(thread.stats, stats::Counter::SeePrune, depth);
 					continue;
+				}
 			}
 
-			if (!pos.isLegal(move))
-				continue;
+			assert(pos.isLegal(move));
 
 			if (pvNode)
 				stack.pv.length = 0;
 
-			++thread.search.nodes;
+			countNode(thread);
 			++legalMoves;
 
+			stats::inc(thread.stats, stats::Counter::Nodes, depth);
+
 			i32 extension{};
 
 			// Singular extensions (SE)
@@ -683,30 +906,60 @@ namespace stormphranj::search
 						// *drastically* below the TT score, then extend by 3 plies.
 						extension = 2 + (!ttMoveNoisy && score < sBeta - tripleExtensionMargin());
 						++stack.multiExtensions;
+
+						stats::inc(thread.stats, stats::Counter::MultiExt, depth);
+					}
+					else
+					{
+						extension = 1;
+						stats::inc(thread.stats, stats::Counter::SingularExt, depth);
 					}
-					else extension = 1;
 				}
 				// Multicut
 				// The TT move is not singular, and in fact the reduced-depth search also returned
 				// a score that was at least beta - there are probably multiple moves in this position
 				// that will beat beta, so just save the time searching and do a cutoff now
 				else if (score >= beta)
+				{
+					stats::inc(thread.stats, stats::Counter::Multicut, depth);
 					return beta;
+				}
 				else if (ttEntry.score >= beta)
 					extension = -2;
 				else if (cutnode)
 					extension = -1;
+
+				if (extension < 0)
+					stats::inc(thread.stats, stats::Counter::NegativeExt, depth);
 			}
 
+			// ABDADA
+			// Lazy SMP threads tend to search the same moves at the same time. If another
+			// thread is already searching this one, it is worth less to us - reduce it more
+			bool searchedElsewhere = false;
+			const auto searchingGuard = m_abdada
+					&& m_threads.size() > 1
+					&& !RootNode
+					&& depth >= MinAbdadaDepth
+					&& legalMoves > 1
+				? m_searchingTable.enter(pos.key(), move, thread.id, searchedElsewhere)
+				: SearchingTable::Guard{};
+
 			// prefetch as early as possible
 			m_ttable.prefetch(pos.roughKeyAfter(move));
 
 			const auto movingPiece = boards.pieceAt(move.src());
 			assert(movingPiece != Piece::None);
 
-			const auto guard = pos.applyMove(move, &thread.nnueState);
-
 			thread.prevMoves[ply] = {movingPiece, move.src(), move.dst()};
+			stack.contEntry = &thread.history.contEntry(thread.prevMoves[ply]);
+
+			// the child scores its quiets against this entry, but it is
+			// not worth pulling in for nodes that drop straight into qsearch
+			if (depth > 1)
+				stack.contEntry->prefetch(oppColor(pieceColor(movingPiece)));
+
+			const auto guard = pos.applyMove(move, &thread.nnueState);
 
 			Score score{};
 
@@ -752,6 +1005,9 @@ namespace stormphranj::search
 						// reduce more if static eval is significantly below alpha
 						lmr += std::clamp((alpha - stack.staticEval) / evalDeltaLmrDiv(), 0, maxEvalDeltaReduction());
 
+						// reduce more if another thread is already searching this move
+						lmr += searchedElsewhere;
+
 						return lmr;
 					}();
 
@@ -761,6 +1017,9 @@ namespace stormphranj::search
 					score = -search(thread, stack.pv, reduced,
 						ply + 1, moveStackIdx + 1, -alpha - 1, -alpha, true);
 
+					if (reduced < newDepth)
+						stats::inc(thread.stats, stats::Counter::LmrSearch, depth);
+
 					if (score > alpha && reduced < newDepth)
 					{
 						const bool doDeeperSearch = score > bestScore
@@ -770,8 +1029,11 @@ namespace stormphranj::search
 						newDepth += doDeeperSearch - doShallowerSearch;
 
 						if (newDepth > reduced)
+						{
 							score = -search(thread, stack.pv, newDepth,
 								ply + 1, moveStackIdx + 1, -alpha - 1, -alpha, !cutnode);
+							stats::inc(thread.stats, stats::Counter::LmrResearch, depth);
+						}
 					}
 
 					if (score > alpha && score < beta)
@@ -783,6 +1045,25 @@ namespace stormphranj::search
 			{
 				if (thread.isMainThread())
 					m_limiter->updateMoveNodes(move, thread.search.nodes - prevNodes);
+
+				if (!m_stop.load(std::memory_order::relaxed))
+				{
+					auto &rootMove = thread.findRootMove(move);
+
+					rootMove.nodes += thread.search.nodes - prevNodes;
+
+					// fail-lows only have an upper bound, and their pv is meaningless
+					if (legalMoves == 1 || score > alpha)
+					{
+						rootMove.score = score;
+
+						rootMove.pv.moves[0] = move;
+						std::copy(stack.pv.moves.begin(), stack.pv.moves.begin() + stack.pv.length,
+							rootMove.pv.moves.begin() + 1);
+						rootMove.pv.length = stack.pv.length + 1;
+					}
+					else rootMove.score = -ScoreInf;
+				}
 			}
 
 			if (score > bestScore)
@@ -806,6 +1087,8 @@ namespace stormphranj::search
 				{
 					if (score >= beta)
 					{
+						stats::cutoff(thread.stats, depth, legalMoves - 1);
+
 						const auto historyDepth = depth + (stack.staticEval <= alpha);
 
 						// Update history on fail-highs
@@ -820,19 +1103,19 @@ namespace stormphranj::search
 						if (quietOrLosing)
 						{
 							stack.killer = move;
-							thread.history.updateCountermove(ply, thread.prevMoves, move);
+							thread.history.updateCountermove(prevMove, move);
 						}
 
 						if (noisy)
 							thread.history.updateNoisyScore(currMove, threats, captured, bonus);
 						else
 						{
-							thread.history.updateQuietScore(currMove, threats, ply, thread.prevMoves, bonus);
+							thread.history.updateQuietScore(currMove, threats, continuations, bonus);
 
 							// Penalise quiet moves that did not fail high if the fail-high move is quiet
 							for (const auto prevQuiet : moveStack.quietsTried)
 							{
-								thread.history.updateQuietScore(prevQuiet, threats, ply, thread.prevMoves, penalty);
+								thread.history.updateQuietScore(prevQuiet, threats, continuations, penalty);
 							}
 						}
 
@@ -864,8 +1147,9 @@ namespace stormphranj::search
 			return -ScoreMate + ply;
 		}
 
-		if (!stack.excluded && !shouldStop(thread.search, false, false))
-			m_ttable.put(pos.key(), bestScore, bestMove, depth, ply, entryType);
+		// don't let secondary multipv lines overwrite the root's best move
+		if (!stack.excluded && (!RootNode || thread.pvIdx == 0) && !shouldStop(thread.search, false, false))
+			m_ttable.put(pos.key(), bestScore, rawEval, bestMove, depth, ply, entryType);
 
 		return bestScore;
 	}
@@ -895,18 +1179,28 @@ namespace stormphranj::search
 		ProbedTTableEntry ttEntry{};
 		m_ttable.probe(ttEntry, pos.key(), ply);
 
+		++thread.search.ttProbes;
+		thread.search.ttHits += ttEntry.type != EntryType::None;
+
 		if (ttEntry.type == EntryType::Exact
 			|| ttEntry.type == EntryType::Alpha && ttEntry.score <= alpha
 			|| ttEntry.type == EntryType::Beta  && ttEntry.score >= beta)
+		{
+			stats::inc(thread.stats, stats::QsearchCounter::TtCutoff);
 			return ttEntry.score;
+		}
+
+		Score rawEval = NoTtStaticEval;
 
 		const auto eval = [&]
 		{
+			// every evasion is searched, so this only stands if there are none
 			if (pos.isCheck())
-				return -ScoreMate;
+				return -ScoreMate + ply;
 			else
 			{
-				const auto staticEval = eval::staticEval(pos, thread.nnueState, m_contempt);
+				rawEval = rawStaticEval(thread, ttEntry);
+				const auto staticEval = eval::adjustEval(pos, m_contempt, rawEval);
 				return (ttEntry.type == EntryType::Exact
 						|| ttEntry.type == EntryType::Alpha && ttEntry.score < staticEval
 						|| ttEntry.type == EntryType::Beta  && ttEntry.score > staticEval)
@@ -918,7 +1212,10 @@ namespace stormphranj::search
 		if (eval > alpha)
 		{
 			if (eval >= beta)
+			{
+				stats::inc(thread.stats, stats::QsearchCounter::StandPat);
 				return eval;
+			}
 
 			alpha = eval;
 		}
@@ -941,13 +1238,14 @@ namespace stormphranj::search
 
 		while (const auto move = generator.next())
 		{
-			if (!pos.isLegal(move.move))
-				continue;
+			assert(pos.isLegal(move.move));
 
 			if (!pos.isCheck()
 				&& futility <= alpha
 				&& !see::see(pos, move.move, 1))
 			{
+				stats::inc(thread.stats, stats::QsearchCounter::Pruned);
+
 				if (bestScore < futility)
 					bestScore = futility;
 				continue;
@@ -958,7 +1256,8 @@ namespace stormphranj::search
 
 			const auto guard = pos.applyMove(move.move, &thread.nnueState);
 
-			++thread.search.nodes;
+			countNode(thread);
+			stats::inc(thread.stats, stats::QsearchCounter::Nodes);
 
 			Score score;
 
@@ -987,29 +1286,58 @@ namespace stormphranj::search
 		}
 
 		if (!shouldStop(thread.search, false, false))
-			m_ttable.put(pos.key(), bestScore, best, 0, ply, entryType);
+			m_ttable.put(pos.key(), bestScore, rawEval, best, 0, ply, entryType);
 
 		return bestScore;
 	}
 
+	auto Searcher::reportLines(const ThreadData &mainThread, const PvList &pv, i32 depth, f64 time, Score score) -> void
+	{
+		const auto lines = std::min(static_cast<usize>(m_multiPv), mainThread.rootMoves().size());
+
+		if (lines <= 1)
+		{
+			report(mainThread, pv, depth, time, score, -ScoreInf, ScoreInf);
+			return;
+		}
+
+		for (usize i = 0; i < lines; ++i)
+		{
+			const auto &rootMove = mainThread.rootMoves()[i];
+
+			// not (yet) searched to this depth, fall back to the last result
+			const auto lineScore = rootMove.score == -ScoreInf ? rootMove.previousScore : rootMove.score;
+
+			if (lineScore == -ScoreInf || rootMove.pv.length == 0)
+				continue;
+
+			report(mainThread, rootMove.pv, depth, time, lineScore, -ScoreInf, ScoreInf, static_cast<u32>(i + 1));
+		}
+	}
+
 	auto Searcher::report(const ThreadData &mainThread, const PvList &pv,
-		i32 depth, f64 time, Score score, Score alpha, Score beta) -> void
+		i32 depth, f64 time, Score score, Score alpha, Score beta, u32 line) -> void
 	{
-		usize nodes = 0;
+		const auto nodes = m_totalNodes.load(std::memory_order::relaxed)
+			+ mainThread.search.nodes % NodeFlushInterval;
+
 		i32 seldepth = 0;
 
 		// technically a potential race but it doesn't matter
 		for (const auto &thread : m_threads)
 		{
-			nodes += thread.search.nodes;
 			seldepth = std::max(seldepth, thread.search.seldepth);
 		}
 
 		const auto ms  = static_cast<usize>(time * 1000.0);
 		const auto nps = static_cast<usize>(static_cast<f64>(nodes) / time);
 
-		std::cout << "info depth " << depth << " seldepth " << seldepth
-			<< " time " << ms << " nodes " << nodes << " nps " << nps << " score ";
+		std::cout << "info depth " << depth << " seldepth " << seldepth;
+
+		if (m_multiPv > 1)
+			std::cout << " multipv " << line;
+
+		std::cout << " time " << ms << " nodes " << nodes << " nps " << nps << " score ";
 
 		score = std::clamp(score, alpha, beta);
 
@@ -1069,4 +1397,29 @@ namespace stormphranj::search
 
 		std::cout << std::endl;
 	}
+
+	auto Searcher::reportThreadStats(f64 time) -> void
+	{
+		const auto flags = std::cout.flags();
+		const auto precision = std::cout.precision();
+
+		std::cout << std::fixed << std::setprecision(1);
+
+		// racy in the same way as report(), which is fine for reporting
+		for (const auto &thread : m_threads)
+		{
+			const auto &data = thread.search;
+
+			const auto nps = static_cast<usize>(static_cast<f64>(data.nodes) / time);
+			const auto ttHitRate = data.ttProbes == 0 ? 0.0
+				: static_cast<f64>(data.ttHits) * 100.0 / static_cast<f64>(data.ttProbes);
+
+			std::cout << "info string thread " << thread.id << " nodes " << data.nodes << " nps " << nps
+				<< " depth " << data.completedDepth << " seldepth " << data.seldepth
+				<< " tthits " << ttHitRate << '%' << std::endl;
+		}
+
+		std::cout.flags(flags);
+		std::cout.precision(precision);
+	}
 }
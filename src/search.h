@@ -31,6 +31,7 @@
 #include <condition_variable>
 #include <vector>
 #include <algorithm>
+#include <span>
 
 #include "search_fwd.h"
 #include "position/position.h"
@@ -40,18 +41,24 @@
 #include "eval/eval.h"
 #include "movegen.h"
 #include "util/barrier.h"
+#include "searching_table.h"
+#include "search_stats.h"
 
 namespace stormphranj::search
 {
 	struct BenchData
 	{
 		SearchData search{};
+		stats::SearchStats stats{};
 		f64 time{};
 	};
 
 	constexpr u32 DefaultThreadCount = 1;
 	constexpr auto ThreadCountRange = util::Range<u32>{1,  2048};
 
+	constexpr u32 DefaultMultiPv = 1;
+	constexpr auto MultiPvRange = util::Range<u32>{1, 256};
+
 	constexpr auto SyzygyProbeDepthRange = util::Range<i32>{1, MaxDepth};
 	constexpr auto SyzygyProbeLimitRange = util::Range<i32>{0, 7};
 
@@ -67,6 +74,20 @@ namespace stormphranj::search
 		}
 	};
 
+	struct RootMove
+	{
+		Move move{NullMove};
+
+		// -ScoreInf if not searched yet this iteration, or failed low
+		Score score{-ScoreInf};
+		Score previousScore{-ScoreInf};
+
+		// nodes spent on this move in the current iteration
+		usize nodes{};
+
+		PvList pv{};
+	};
+
 	struct SearchStackEntry
 	{
 		Move killer{NullMove};
@@ -78,6 +99,9 @@ namespace stormphranj::search
 
 		i32 history{};
 
+		// continuation history entry for the move made at this ply
+		ContinuationEntry *contEntry{};
+
 		i32 multiExtensions{0};
 
 		PvList pv{};
@@ -104,12 +128,20 @@ namespace stormphranj::search
 		// this is in here so clion in its infinite wisdom doesn't
 		// mark the entire iterative deepening loop unreachable
 		i32 maxDepth{};
-		SearchData search{};
 
-		bool datagen{false};
+		// read by the main thread while reporting, kept on its own cache line
+		alignas(SPJ_CACHE_LINE_SIZE) SearchData search{};
+
+		alignas(SPJ_CACHE_LINE_SIZE) bool datagen{false};
 
 		PvList rootPv{};
 
+		stats::SearchStats stats{};
+
+		// legal root moves, sorted by score and then node count after each pv line
+		std::vector<RootMove> rootMoveTable{};
+		u32 pvIdx{};
+
 		eval::NnueState nnueState{};
 
 		std::vector<SearchStackEntry> stack{};
@@ -122,9 +154,65 @@ namespace stormphranj::search
 
 		i32 minNmpPly{0};
 
+		[[nodiscard]] inline auto continuations(i32 ply) const -> ContinuationEntries
+		{
+			return {
+				ply > 0 ? stack[ply - 1].contEntry : nullptr,
+				ply > 1 ? stack[ply - 2].contEntry : nullptr,
+				ply > 3 ? stack[ply - 4].contEntry : nullptr
+			};
+		}
+
 		[[nodiscard]] inline auto rootMoves() -> auto &
 		{
-			return moveStack[0].movegenData.moves;
+			return rootMoveTable;
+		}
+
+		[[nodiscard]] inline auto rootMoves() const -> const auto &
+		{
+			return rootMoveTable;
+		}
+
+		// pos must already be set up
+		inline auto setRootMoves(const ScoredMoveList &moves)
+		{
+			moveStack[0].movegenData.moves = moves;
+			moveStack[0].movegenData.preordered = false;
+
+			rootMoveTable.clear();
+
+			for (const auto [move, score] : moves)
+			{
+				rootMoveTable.push_back({move});
+			}
+		}
+
+		// makes the root move generator follow the order of the root move table
+		inline auto orderRootMoves()
+		{
+			auto &movegenData = moveStack[0].movegenData;
+
+			movegenData.moves.clear();
+			movegenData.ranks.resize(rootMoveTable.size());
+
+			for (usize i = 0; i < rootMoveTable.size(); ++i)
+			{
+				const auto rank = static_cast<i32>(rootMoveTable.size() - i);
+
+				movegenData.moves.push({rootMoveTable[i].move, rank});
+				movegenData.ranks[i] = rank;
+			}
+
+			movegenData.preordered = true;
+		}
+
+		[[nodiscard]] inline auto findRootMove(Move move) -> RootMove &
+		{
+			const auto rootMove = std::find_if(rootMoveTable.begin(), rootMoveTable.end(),
+				[move](const auto &m) { return m.move == move; });
+			assert(rootMove != rootMoveTable.end());
+
+			return *rootMove;
 		}
 
 		[[nodiscard]] inline auto isMainThread() const
@@ -151,9 +239,19 @@ namespace stormphranj::search
 			m_limiter = std::move(limiter);
 		}
 
-		auto startSearch(const Position &pos, i32 maxDepth, std::unique_ptr<limit::ISearchLimiter> limiter) -> void;
+		// searchMoves restricts the root to the given moves, if not empty
+		auto startSearch(const Position &pos, i32 maxDepth, std::unique_ptr<limit::ISearchLimiter> limiter,
+			std::span<const Move> searchMoves = {}, bool ponder = false) -> void;
 		auto stop() -> void;
 
+		// installs the real limiter into a running ponder search
+		auto ponderhit(std::unique_ptr<limit::ISearchLimiter> limiter) -> void;
+
+		[[nodiscard]] inline auto pondering() const
+		{
+			return m_pondering.load(std::memory_order::acquire);
+		}
+
 		// -> [move, unnormalised, normalised]
 		auto runDatagenSearch(ThreadData &thread) -> std::pair<Score, Score>;
 
@@ -167,6 +265,11 @@ namespace stormphranj::search
 
 		auto setThreads(u32 threads) -> void;
 
+		[[nodiscard]] inline auto threadCount() const
+		{
+			return static_cast<u32>(m_threads.size());
+		}
+
 		inline auto clearTt()
 		{
 			m_ttable.clear();
@@ -177,6 +280,32 @@ namespace stormphranj::search
 			m_ttable.resize(size);
 		}
 
+		inline auto setAbdada(bool abdada)
+		{
+			m_abdada = abdada;
+		}
+
+		[[nodiscard]] inline auto abdada() const
+		{
+			return m_abdada;
+		}
+
+		// nodes searched by all threads, exact once the search has finished
+		[[nodiscard]] inline auto totalNodes() const
+		{
+			return m_totalNodes.load(std::memory_order::relaxed);
+		}
+
+		inline auto setMultiPv(u32 multiPv)
+		{
+			m_multiPv = multiPv;
+		}
+
+		inline auto setReportThreadStats(bool reportThreadStats)
+		{
+			m_reportThreadStats = reportThreadStats;
+		}
+
 		inline auto quit() -> void
 		{
 			m_quit.store(true, std::memory_order::release);
@@ -188,6 +317,13 @@ namespace stormphranj::search
 	private:
 		TTable m_ttable{};
 
+		SearchingTable m_searchingTable{};
+		bool m_abdada{false};
+
+		u32 m_multiPv{DefaultMultiPv};
+
+		bool m_reportThreadStats{false};
+
 		u32 m_nextThreadId{};
 		std::vector<ThreadData> m_threads{};
 
@@ -201,23 +337,49 @@ namespace stormphranj::search
 
 		util::Barrier m_searchEndBarrier{1};
 
-		std::atomic_int m_stop{};
+		// read by every thread at every node, so kept on a line of its own
+		// instead of next to the barriers and mutexes written around it
+		alignas(SPJ_CACHE_LINE_SIZE) std::atomic_int m_stop{};
 
-		std::mutex m_stopMutex{};
+		alignas(SPJ_CACHE_LINE_SIZE) std::mutex m_stopMutex{};
 		std::condition_variable m_stopSignal{};
 		std::atomic_int m_runningThreads{};
 
-		std::unique_ptr<limit::ISearchLimiter> m_limiter{};
+		// each thread adds its node count in here every NodeFlushInterval
+		// nodes, so that reporting does not need to read every thread's counter
+		alignas(SPJ_CACHE_LINE_SIZE) std::atomic<usize> m_totalNodes{};
+
+		alignas(SPJ_CACHE_LINE_SIZE) std::unique_ptr<limit::ISearchLimiter> m_limiter{};
+
+		std::atomic_bool m_pondering{};
+
+		// set on ponderhit, the main search thread swaps the pending limiter in at its next limiter check
+		std::atomic_bool m_limiterPending{};
+		std::unique_ptr<limit::ISearchLimiter> m_pendingLimiter{};
+
+		std::mutex m_ponderMutex{};
+		std::condition_variable m_ponderSignal{};
 
 		Score m_minRootScore{};
 		Score m_maxRootScore{};
 
 		eval::Contempt m_contempt{};
 
+		static constexpr usize NodeFlushInterval = 1024;
+
 		auto stopThreads() -> void;
 
 		auto run(ThreadData &thread) -> void;
 
+		// kept out of line, so the atomic does not get in the way of optimising the search
+		auto flushNodes() -> void;
+
+		inline auto countNode(ThreadData &thread)
+		{
+			if (++thread.search.nodes % NodeFlushInterval == 0) [[unlikely]]
+				flushNodes();
+		}
+
 		[[nodiscard]] inline auto shouldStop(const SearchData &data, bool checkLimiter, bool allowSoftTimeout) -> bool
 		{
 			if (checkLimiter)
@@ -225,6 +387,9 @@ namespace stormphranj::search
 				if (m_stop.load(std::memory_order::relaxed))
 					return true;
 
+				if (m_limiterPending.load(std::memory_order::relaxed)) [[unlikely]]
+					installPendingLimiter();
+
 				if (m_limiter->stop(data, allowSoftTimeout))
 				{
 					m_stop.store(true, std::memory_order::relaxed);
@@ -235,6 +400,8 @@ namespace stormphranj::search
 			return m_stop.load(std::memory_order::relaxed);
 		}
 
+		auto installPendingLimiter() -> void;
+
 		auto searchRoot(ThreadData &thread, bool mainSearchThread) -> Score;
 
 		template <bool Root = false>
@@ -242,7 +409,12 @@ namespace stormphranj::search
 			u32 moveStackIdx, Score alpha, Score beta, bool cutnode) -> Score;
 		auto qsearch(ThreadData &thread, i32 ply, u32 moveStackIdx, Score alpha, Score beta) -> Score;
 
+		// reports every pv line in multipv, or just the given one
+		auto reportLines(const ThreadData &mainThread, const PvList &pv, i32 depth, f64 time, Score score) -> void;
 		auto report(const ThreadData &mainThread, const PvList &pv,
-			i32 depth, f64 time, Score score, Score alpha, Score beta) -> void;
+			i32 depth, f64 time, Score score, Score alpha, Score beta, u32 line = 1) -> void;
+
+		// per-thread nodes, nps, completed depth and tt hit rate, for spotting stragglers
+		auto reportThreadStats(f64 time) -> void;
 	};
 }
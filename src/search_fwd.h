@@ -29,5 +29,14 @@ namespace stormphranj::search
 		i32 depth{};
 		i32 seldepth{};
 		usize nodes{};
+
+		i32 completedDepth{};
+
+		usize ttProbes{};
+		usize ttHits{};
+
+		// static evals computed by the network, and taken from the tt instead
+		usize nnueEvals{};
+		usize ttEvals{};
 	};
 }
@@ -0,0 +1,131 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "search_stats.h"
+
+#if SPJ_SEARCH_STATS
+#include <iostream>
+#include <iomanip>
+#include <string_view>
+#endif
+
+namespace stormphranj::search::stats
+{
+#if SPJ_SEARCH_STATS
+	namespace
+	{
+		constexpr auto CounterNames = std::array {
+			std::string_view{"nodes"},
+			std::string_view{"tt"},
+			std::string_view{"rfp"},
+			std::string_view{"nmp"},
+			std::string_view{"lmp"},
+			std::string_view{"fp"},
+			std::string_view{"see"},
+			std::string_view{"se"},
+			std::string_view{"multi"},
+			std::string_view{"negext"},
+			std::string_view{"mcut"},
+			std::string_view{"lmr"},
+			std::string_view{"re"},
+			std::string_view{"cutoff"},
+		};
+
+		static_assert(CounterNames.size() == static_cast<usize>(Counter::Count));
+
+		constexpr i32 ColumnWidth = 10;
+
+		inline auto percent(usize n, usize total)
+		{
+			return total == 0 ? 0.0 : static_cast<f64>(n) * 100.0 / static_cast<f64>(total);
+		}
+	}
+
+	auto print(const SearchStats &stats) -> void
+	{
+		const auto flags = std::cout.flags();
+		const auto precision = std::cout.precision();
+
+		std::cout << "\nsearch stats by depth\n";
+
+		std::cout << std::setw(5) << "depth";
+		for (const auto name : CounterNames)
+		{
+			std::cout << std::setw(ColumnWidth) << name;
+		}
+		std::cout << '\n';
+
+		for (i32 depth = 0; depth < DepthBuckets; ++depth)
+		{
+			bool any = false;
+			for (const auto &counter : stats.counters)
+			{
+				any |= counter[depth] > 0;
+			}
+
+			if (!any)
+				continue;
+
+			std::cout << std::setw(4) << depth << (depth == DepthBuckets - 1 ? "+" : " ");
+
+			for (const auto &counter : stats.counters)
+			{
+				std::cout << std::setw(ColumnWidth) << counter[depth];
+			}
+
+			std::cout << '\n';
+		}
+
+		usize cutoffs{};
+		for (const auto count : stats.cutoffIndices)
+		{
+			cutoffs += count;
+		}
+
+		std::cout << "\nbeta cutoffs by move index\n";
+
+		for (u32 idx = 0; idx < CutoffIndexBuckets; ++idx)
+		{
+			std::cout << std::setw(4) << (idx + 1) << (idx == CutoffIndexBuckets - 1 ? "+ " : "  ")
+				<< std::fixed << std::setprecision(2) << std::setw(6)
+				<< percent(stats.cutoffIndices[idx], cutoffs) << "%\n";
+		}
+
+		usize searchNodes{};
+		for (const auto count : stats.counters[static_cast<usize>(Counter::Nodes)])
+		{
+			searchNodes += count;
+		}
+
+		const auto qsearchNodes = stats.qsearchCounters[static_cast<usize>(QsearchCounter::Nodes)];
+
+		std::cout << "\nqsearch nodes: " << qsearchNodes << " ("
+			<< percent(qsearchNodes, searchNodes + qsearchNodes) << "% of all nodes)\n";
+		std::cout << "qsearch tt cutoffs: " << stats.qsearchCounters[static_cast<usize>(QsearchCounter::TtCutoff)] << '\n';
+		std::cout << "qsearch stand pat cutoffs: "
+			<< stats.qsearchCounters[static_cast<usize>(QsearchCounter::StandPat)] << '\n';
+		std::cout << "qsearch pruned moves: " << stats.qsearchCounters[static_cast<usize>(QsearchCounter::Pruned)]
+			<< std::endl;
+
+		std::cout.flags(flags);
+		std::cout.precision(precision);
+	}
+#else
+	auto print(const SearchStats &stats) -> void {}
+#endif
+}
@@ -0,0 +1,128 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <algorithm>
+
+namespace stormphranj::search::stats
+{
+	// Search tree statistics, compiled in with SPJ_SEARCH_STATS
+	// When disabled, SearchStats is empty and every function here is a no-op
+
+	enum class Counter : u32
+	{
+		Nodes = 0,
+		TtCutoff,
+		Rfp,
+		Nmp,
+		Lmp,
+		Fp,
+		SeePrune,
+		SingularExt,
+		MultiExt,
+		NegativeExt,
+		Multicut,
+		LmrSearch,
+		LmrResearch,
+		BetaCutoff,
+		Count,
+	};
+
+	enum class QsearchCounter : u32
+	{
+		Nodes = 0,
+		TtCutoff,
+		StandPat,
+		Pruned,
+		Count,
+	};
+
+	// depths beyond the last bucket are counted in it
+	constexpr i32 DepthBuckets = 32;
+	constexpr u32 CutoffIndexBuckets = 16;
+
+	struct SearchStats
+	{
+#if SPJ_SEARCH_STATS
+		std::array<std::array<usize, DepthBuckets>, static_cast<usize>(Counter::Count)> counters{};
+		std::array<usize, static_cast<usize>(QsearchCounter::Count)> qsearchCounters{};
+
+		// index of the move that caused a beta cutoff, 0 being the first legal move
+		std::array<usize, CutoffIndexBuckets> cutoffIndices{};
+
+		inline auto operator+=(const SearchStats &other) -> SearchStats &
+		{
+			for (usize counter = 0; counter < counters.size(); ++counter)
+			{
+				for (usize depth = 0; depth < DepthBuckets; ++depth)
+				{
+					counters[counter][depth] += other.counters[counter][depth];
+				}
+			}
+
+			for (usize counter = 0; counter < qsearchCounters.size(); ++counter)
+			{
+				qsearchCounters[counter] += other.qsearchCounters[counter];
+			}
+
+			for (usize idx = 0; idx < CutoffIndexBuckets; ++idx)
+			{
+				cutoffIndices[idx] += other.cutoffIndices[idx];
+			}
+
+			return *this;
+		}
+#else
+		inline auto operator+=(const SearchStats &other) -> SearchStats &
+		{
+			return *this;
+		}
+#endif
+	};
+
+	inline auto inc(SearchStats &stats, Counter counter, i32 depth)
+	{
+#if SPJ_SEARCH_STATS
+		const auto bucket = std::min(std::max(depth, 0), DepthBuckets - 1);
+		++stats.counters[static_cast<usize>(counter)][bucket];
+#endif
+	}
+
+	inline auto inc(SearchStats &stats, QsearchCounter counter)
+	{
+#if SPJ_SEARCH_STATS
+		++stats.qsearchCounters[static_cast<usize>(counter)];
+#endif
+	}
+
+	// moveIdx is the number of legal moves searched before the cutoff move
+	inline auto cutoff(SearchStats &stats, i32 depth, u32 moveIdx)
+	{
+#if SPJ_SEARCH_STATS
+		inc(stats, Counter::BetaCutoff, depth);
+		++stats.cutoffIndices[std::min(moveIdx, CutoffIndexBuckets - 1)];
+#endif
+	}
+
+	// prints nothing when disabled
+	auto print(const SearchStats &stats) -> void;
+}
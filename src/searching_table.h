@@ -0,0 +1,105 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <memory>
+
+#include "move.h"
+
+namespace stormphranj::search
+{
+	// ABDADA-style table of (position, move) pairs that some thread is currently searching,
+	// so other lazy smp threads can reduce those moves further instead of duplicating the work.
+	// Nothing is locked and a slot is only taken while it is free, so two threads can
+	// occasionally both claim one, or a busy move can go unnoticed - this only ever costs
+	// a reduction either way
+	class SearchingTable
+	{
+		struct Entry
+		{
+			std::atomic<u64> key{};
+			std::atomic<u32> owner{};
+		};
+
+	public:
+		class Guard
+		{
+		public:
+			Guard() = default;
+
+			~Guard()
+			{
+				if (m_entry)
+					m_entry->key.store(0, std::memory_order::relaxed);
+			}
+
+			Guard(const Guard &) = delete;
+			Guard(Guard &&) = delete;
+
+			auto operator=(const Guard &) -> Guard & = delete;
+			auto operator=(Guard &&) -> Guard & = delete;
+
+		private:
+			explicit Guard(Entry *entry)
+				: m_entry{entry} {}
+
+			Entry *m_entry{};
+
+			friend class SearchingTable;
+		};
+
+		SearchingTable()
+			: m_entries{std::make_unique<Entry[]>(Size)} {}
+
+		~SearchingTable() = default;
+
+		// Marks a move as being searched by this thread until the returned guard is destroyed.
+		// Sets searchedElsewhere if another thread had already marked the same move
+		[[nodiscard]] inline auto enter(u64 key, Move move, u32 threadId, bool &searchedElsewhere) -> Guard
+		{
+			// never 0, which marks a free slot
+			const auto hash = (key ^ (static_cast<u64>(move.data()) * U64(0x9E3779B97F4A7C15))) | 1;
+			auto &entry = m_entries[hash >> (64 - SizeBits)];
+
+			const auto current = entry.key.load(std::memory_order::relaxed);
+
+			if (current == 0)
+			{
+				entry.key.store(hash, std::memory_order::relaxed);
+				entry.owner.store(threadId, std::memory_order::relaxed);
+
+				searchedElsewhere = false;
+				return Guard{&entry};
+			}
+
+			searchedElsewhere = current == hash
+				&& entry.owner.load(std::memory_order::relaxed) != threadId;
+			return Guard{};
+		}
+
+	private:
+		static constexpr u32 SizeBits = 14;
+		static constexpr usize Size = usize{1} << SizeBits;
+
+		std::unique_ptr<Entry[]> m_entries;
+	};
+}
@@ -25,6 +25,8 @@
 #include "core.h"
 #include "position/position.h"
 #include "attacks/attacks.h"
+#include "rays.h"
+#include "profile.h"
 
 namespace stormphranj::see
 {
@@ -93,10 +95,12 @@ namespace stormphranj::see
 	}
 
 	// basically ported from ethereal and weiss (their implementation is the same)
-	inline auto see(const Position &pos, Move move, Score threshold = 0)
+	[[nodiscard]] inline auto see(const Position &pos, Move move, Score threshold = 0)
 	{
-		const auto &boards = pos.boards();
-		const auto &bbs = boards.bbs();
+		SPJ_PROFILE_SCOPE(See);
+
+		const auto boards = pos.boards();
+		const auto &bbs = pos.bbs();
 
 		const auto color = pos.toMove();
 
@@ -116,6 +120,11 @@ namespace stormphranj::see
 
 		const auto square = move.dst();
 
+		// nothing can recapture, unless the moving piece was blocking an enemy rook
+		if (!pos.threats()[square]
+			&& (orthoRayIntersecting(move.src(), square) & bbs.rooks(oppColor(color))).empty())
+			return true;
+
 		auto occupancy = bbs.occupancy()
 			^ squareBit(move.src())
 			^ squareBit(square);
@@ -135,6 +144,7 @@ namespace stormphranj::see
 
 			next = popLeastValuable(bbs, occupancy, ourAttackers, us);
 
+			// every other piece is a leaper, so only rooks can uncover x-rays
 			if (next == PieceType::Rook)
 				attackers |= attacks::getRookAttacks(square, occupancy) & rooks;
 
@@ -18,13 +18,16 @@
 
 #include "ttable.h"
 
-#include <cstring>
 #include <bit>
+#include <algorithm>
+#include <limits>
 
 #ifndef NDEBUG
 #include <iostream>
 #endif
 
+#include "profile.h"
+
 namespace stormphranj
 {
 	namespace
@@ -53,6 +56,15 @@ namespace stormphranj
 		{
 			return static_cast<u16>(key);
 		}
+
+		inline auto staticEvalToTt(Score staticEval)
+		{
+			if (staticEval == NoTtStaticEval)
+				return NoTtStaticEval;
+
+			return static_cast<i16>(std::clamp<Score>(staticEval,
+				std::numeric_limits<i16>::min() + 1, std::numeric_limits<i16>::max()));
+		}
 	}
 
 	TTable::TTable(usize size)
@@ -64,7 +76,7 @@ namespace stormphranj
 	{
 		size *= 1024 * 1024;
 
-		const auto capacity = size / sizeof(TTableEntry);
+		const auto capacity = size / sizeof(TTableCluster);
 
 		//TODO handle oom
 		m_table.resize(capacity);
@@ -75,28 +87,70 @@ namespace stormphranj
 
 	auto TTable::probe(ProbedTTableEntry &dst, u64 key, i32 ply) const -> void
 	{
-		const auto entry = loadEntry(index(key));
+		SPJ_PROFILE_SCOPE(TtProbe);
+
+		const auto &cluster = m_table[index(key)];
+		const auto entryKey = packEntryKey(key);
 
-		if (entry.type != EntryType::None
-			&& packEntryKey(key) == entry.key)
+		for (usize i = 0; i < TTableCluster::EntryCount; ++i)
 		{
-			dst.score = scoreFromTt(static_cast<Score>(entry.score), ply);
-			dst.depth = entry.depth;
-			dst.move = entry.move;
-			dst.type = entry.type;
+			const auto entry = loadEntry(cluster, i);
+
+			if (entry.type != EntryType::None
+				&& entry.key == entryKey)
+			{
+				dst.score = scoreFromTt(static_cast<Score>(entry.score), ply);
+				dst.staticEval = entry.staticEval;
+				dst.depth = entry.depth;
+				dst.move = entry.move;
+				dst.type = entry.type;
+
+				return;
+			}
 		}
-		else dst.type = EntryType::None;
+
+		dst.staticEval = NoTtStaticEval;
+		dst.type = EntryType::None;
 	}
 
-	auto TTable::put(u64 key, Score score, Move move, i32 depth, i32 ply, EntryType type) -> void
+	auto TTable::put(u64 key, Score score, Score staticEval, Move move, i32 depth, i32 ply, EntryType type) -> void
 	{
+		SPJ_PROFILE_SCOPE(TtPut);
+
 		assert(depth >= 0);
 		assert(depth <= MaxDepth);
 
-		auto entry = loadEntry(index(key));
+		auto &cluster = m_table[index(key)];
 
 		const auto entryKey = packEntryKey(key);
 
+		// Replace an entry from the same position if there is one, otherwise
+		// the shallowest entry, preferring entries from previous searches
+		usize idx = 0;
+		i32 minValue = std::numeric_limits<i32>::max();
+
+		for (usize i = 0; i < TTableCluster::EntryCount; ++i)
+		{
+			const auto candidate = loadEntry(cluster, i);
+
+			if (candidate.key == entryKey || candidate.type == EntryType::None)
+			{
+				idx = i;
+				break;
+			}
+
+			const i32 relativeAge = (64 + m_currentAge - candidate.age) % 64;
+			const i32 value = candidate.depth - relativeAge * 4;
+
+			if (value < minValue)
+			{
+				idx = i;
+				minValue = value;
+			}
+		}
+
+		auto entry = loadEntry(cluster, idx);
+
 		// always replace empty entries
 		const bool replace = entry.key == 0
 			// always replace with PV entries
@@ -115,6 +169,10 @@ namespace stormphranj
 			std::cerr << "trying to put out of bounds score " << score << " into ttable" << std::endl;
 #endif
 
+		// keep the existing static eval if we have none to store
+		if (staticEval != NoTtStaticEval || entry.key != entryKey || entry.type == EntryType::None)
+			entry.staticEval = staticEvalToTt(staticEval);
+
 		entry.key = entryKey;
 		entry.score = static_cast<i16>(scoreToTt(score, ply));
 		entry.move = move;
@@ -122,14 +180,14 @@ namespace stormphranj
 		entry.age = m_currentAge;
 		entry.type = type;
 
-		storeEntry(index(key), entry);
+		storeEntry(cluster, idx, entry);
 	}
 
 	auto TTable::clear() -> void
 	{
 		m_currentAge = 0;
 
-		std::memset(m_table.data(), 0, m_table.size() * sizeof(TTableEntry));
+		std::fill(m_table.begin(), m_table.end(), TTableCluster{});
 	}
 
 	auto TTable::full() const -> u32
@@ -138,11 +196,14 @@ namespace stormphranj
 
 		for (u64 i = 0; i < 1000; ++i)
 		{
-			const auto entry = loadEntry(i);
-			if (entry.type != EntryType::None && entry.age == m_currentAge)
-				++filledEntries;
+			for (usize j = 0; j < TTableCluster::EntryCount; ++j)
+			{
+				const auto entry = loadEntry(m_table[i], j);
+				if (entry.type != EntryType::None && entry.age == m_currentAge)
+					++filledEntries;
+			}
 		}
 
-		return filledEntries;
+		return filledEntries / TTableCluster::EntryCount;
 	}
 }
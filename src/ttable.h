@@ -23,6 +23,9 @@
 #include <vector>
 #include <atomic>
 #include <cstring>
+#include <cstddef>
+#include <array>
+#include <limits>
 
 #include "core.h"
 #include "move.h"
@@ -41,21 +44,39 @@ namespace stormphranj
 		Exact
 	};
 
+	// stored in place of the static eval when there is none (in check)
+	constexpr i16 NoTtStaticEval = std::numeric_limits<i16>::min();
+
 	struct TTableEntry
 	{
 		u16 key;
 		i16 score;
+		// raw nnue output, before any scaling or contempt
+		i16 staticEval;
 		Move move;
 		u8 depth;
 		u8 age : 6;
 		EntryType type : 2;
 	};
 
-	static_assert(sizeof(TTableEntry) == 8);
+	static_assert(sizeof(TTableEntry) == 10);
+	static_assert(offsetof(TTableEntry, key) == 0);
+
+	// 3 entries per half cache line, rather than 4 8-byte entries
+	struct alignas(32) TTableCluster
+	{
+		static constexpr usize EntryCount = 3;
+
+		std::array<TTableEntry, EntryCount> entries;
+		[[maybe_unused]] std::array<u8, 2> padding;
+	};
+
+	static_assert(sizeof(TTableCluster) == 32);
 
 	struct ProbedTTableEntry
 	{
 		i32 score;
+		i32 staticEval;
 		i32 depth;
 		Move move;
 		EntryType type;
@@ -71,7 +92,7 @@ namespace stormphranj
 
 		auto probe(ProbedTTableEntry &dst, u64 key, i32 ply) const -> void;
 
-		auto put(u64 key, Score score, Move move, i32 depth, i32 ply, EntryType type) -> void;
+		auto put(u64 key, Score score, Score staticEval, Move move, i32 depth, i32 ply, EntryType type) -> void;
 
 		auto clear() -> void;
 
@@ -97,28 +118,43 @@ namespace stormphranj
 			return static_cast<u64>((static_cast<u128>(key) * static_cast<u128>(m_table.size())) >> 64);
 		}
 
-		[[nodiscard]] inline auto loadEntry(usize index) const
+		// Entries are 10 bytes and cannot be loaded or stored with a single access, so a
+		// racing thread can tear one, mixing the fields of two writes. The key is stored
+		// xored with the rest of the entry - score, static eval, move, depth and bound
+		// included - so a torn entry fails the key check like any other key collision
+		[[nodiscard]] static inline auto entryCheck(const TTableEntry &entry) -> u16
 		{
-			const auto *ptr = static_cast<volatile const i64 *>(&m_table[index]);
-			const auto v = *ptr;
+			std::array<u16, sizeof(TTableEntry) / sizeof(u16)> words{};
+			std::memcpy(words.data(), &entry, sizeof(TTableEntry));
 
-			TTableEntry entry{};
-			std::memcpy(&entry, &v, sizeof(TTableEntry));
+			u16 check = 0;
 
-			return entry;
+			// skip the key itself
+			for (usize i = 1; i < words.size(); ++i)
+			{
+				check ^= words[i];
+			}
+
+			return check;
 		}
 
-		inline auto storeEntry(usize index, TTableEntry entry)
+		[[nodiscard]] inline auto loadEntry(const TTableCluster &cluster, usize idx) const
 		{
-			auto *ptr = static_cast<volatile i64 *>(&m_table[index]);
+			TTableEntry entry{};
+			std::memcpy(&entry, &cluster.entries[idx], sizeof(TTableEntry));
 
-			i64 v{};
-			std::memcpy(&v, &entry, sizeof(TTableEntry));
+			entry.key ^= entryCheck(entry);
 
-			*ptr = v;
+			return entry;
+		}
+
+		inline auto storeEntry(TTableCluster &cluster, usize idx, TTableEntry entry)
+		{
+			entry.key ^= entryCheck(entry);
+			std::memcpy(&cluster.entries[idx], &entry, sizeof(TTableEntry));
 		}
 
-		std::vector<i64> m_table{};
+		std::vector<TTableCluster> m_table{};
 
 		u8 m_currentAge{};
 	};
@@ -28,6 +28,7 @@
 #include <iomanip>
 #include <atomic>
 #include <unordered_map>
+#include <optional>
 
 #include "util/split.h"
 #include "util/parse.h"
@@ -86,6 +87,7 @@ namespace stormphranj
 			auto handlePosition(const std::vector<std::string> &tokens) -> void;
 			auto handleGo(const std::vector<std::string> &tokens) -> void;
 			auto handleStop() -> void;
+			auto handlePonderhit() -> void;
 			auto handleSetoption(const std::vector<std::string> &tokens) -> void;
 			// V ======= NONSTANDARD ======= V
 			auto handleD() -> void;
@@ -97,7 +99,10 @@ namespace stormphranj
 			auto handleMoves() -> void;
 			auto handlePerft(const std::vector<std::string> &tokens) -> void;
 			auto handleSplitperft(const std::vector<std::string> &tokens) -> void;
+			auto handlePerftsuite() -> void;
 			auto handleBench(const std::vector<std::string> &tokens) -> void;
+			auto handleSmpbench(const std::vector<std::string> &tokens) -> void;
+			auto handleMovebench(const std::vector<std::string> &tokens) -> void;
 #ifndef NDEBUG
 			auto handleVerify() -> void;
 #endif
@@ -107,6 +112,17 @@ namespace stormphranj
 			Position m_pos{Position::starting()};
 
 			i32 m_moveOverhead{limit::DefaultMoveOverhead};
+
+			struct PonderTime
+			{
+				i64 remaining;
+				i64 increment;
+				i32 toGo;
+			};
+
+			// our clock only starts running on ponderhit, so the time manager is created then
+			std::optional<PonderTime> m_ponderTime{};
+			std::unique_ptr<limit::ISearchLimiter> m_ponderLimiter{};
 		};
 
 		UciHandler::~UciHandler()
@@ -140,6 +156,8 @@ namespace stormphranj
 					handleGo(tokens);
 				else if (command == "stop")
 					handleStop();
+				else if (command == "ponderhit")
+					handlePonderhit();
 				else if (command == "setoption")
 					handleSetoption(tokens);
 				// V ======= NONSTANDARD ======= V
@@ -161,8 +179,14 @@ namespace stormphranj
 					handlePerft(tokens);
 				else if (command == "splitperft")
 					handleSplitperft(tokens);
+				else if (command == "perftsuite")
+					handlePerftsuite();
 				else if (command == "bench")
 					handleBench(tokens);
+				else if (command == "smpbench")
+					handleSmpbench(tokens);
+				else if (command == "movebench")
+					handleMovebench(tokens);
 #ifndef NDEBUG
 				else if (command == "verify")
 					handleVerify();
@@ -189,6 +213,11 @@ namespace stormphranj
 			std::cout << "option name Clear Hash type button\n";
 			std::cout << "option name Threads type spin default " << search::DefaultThreadCount
 				<< " min " << search::ThreadCountRange.min() << " max " << search::ThreadCountRange.max() << '\n';
+			std::cout << "option name Ponder type check default false\n";
+			std::cout << "option name ABDADA type check default false\n";
+			std::cout << "option name ThreadStats type check default false\n";
+			std::cout << "option name MultiPV type spin default " << search::DefaultMultiPv
+				<< " min " << search::MultiPvRange.min() << " max " << search::MultiPvRange.max() << '\n';
 			std::cout << "option name Contempt type spin default " << opts::DefaultNormalizedContempt
 				<< " min " << ContemptRange.min() << " max " << ContemptRange.max() << '\n';
 			std::cout << "option name UCI_ShowWDL type check default "
@@ -267,6 +296,9 @@ namespace stormphranj
 				std::unique_ptr<limit::ISearchLimiter> limiter{};
 
 				bool tournamentTime = false;
+				bool ponder = false;
+
+				MoveList searchMoves{};
 
 				const auto startTime = util::g_timer.time();
 
@@ -281,6 +313,33 @@ namespace stormphranj
 						if (!util::tryParseU32(depth, tokens[i]))
 							std::cerr << "invalid depth " << tokens[i] << std::endl;
 					}
+					else if (tokens[i] == "ponder")
+						ponder = true;
+					else if (tokens[i] == "searchmoves")
+					{
+						ScoredMoveList legalMoves{};
+						generateAll(legalMoves, m_pos);
+
+						// consume tokens for as long as they are legal moves
+						while (i + 1 < tokens.size())
+						{
+							const auto &moveStr = tokens[i + 1];
+
+							const auto move = std::ranges::find_if(legalMoves, [&](const auto &m)
+							{
+								return moveToString(m.move) == moveStr;
+							});
+
+							if (move == legalMoves.end())
+								break;
+
+							searchMoves.push(move->move);
+							++i;
+						}
+
+						if (searchMoves.empty())
+							std::cerr << "no legal searchmoves, searching all moves" << std::endl;
+					}
 					else if (!tournamentTime && !limiter)
 					{
 						if (tokens[i] == "infinite")
@@ -394,6 +453,21 @@ namespace stormphranj
 				else if (depth > MaxDepth)
 					depth = MaxDepth;
 
+				if (ponder)
+				{
+					m_ponderTime.reset();
+					m_ponderLimiter.reset();
+
+					if (tournamentTime && timeRemaining > 0)
+						m_ponderTime = PonderTime{timeRemaining, increment, toGo};
+					else m_ponderLimiter = std::move(limiter);
+
+					m_searcher.startSearch(m_pos, static_cast<i32>(depth),
+						std::make_unique<limit::InfiniteLimiter>(), searchMoves, true);
+
+					return;
+				}
+
 				if (tournamentTime && timeRemaining > 0)
 					limiter = std::make_unique<limit::TimeManager>(startTime,
 						static_cast<f64>(timeRemaining) / 1000.0,
@@ -402,7 +476,7 @@ namespace stormphranj
 				else if (!limiter)
 					limiter = std::make_unique<limit::InfiniteLimiter>();
 
-				m_searcher.startSearch(m_pos, static_cast<i32>(depth), std::move(limiter));
+				m_searcher.startSearch(m_pos, static_cast<i32>(depth), std::move(limiter), searchMoves);
 			}
 		}
 
@@ -413,6 +487,30 @@ namespace stormphranj
 			else m_searcher.stop();
 		}
 
+		auto UciHandler::handlePonderhit() -> void
+		{
+			if (!m_searcher.pondering())
+			{
+				std::cerr << "not pondering" << std::endl;
+				return;
+			}
+
+			std::unique_ptr<limit::ISearchLimiter> limiter{};
+
+			if (m_ponderTime)
+				limiter = std::make_unique<limit::TimeManager>(util::g_timer.time(),
+					static_cast<f64>(m_ponderTime->remaining) / 1000.0,
+					static_cast<f64>(m_ponderTime->increment) / 1000.0,
+					m_ponderTime->toGo, static_cast<f64>(m_moveOverhead) / 1000.0);
+			else if (m_ponderLimiter)
+				limiter = std::move(m_ponderLimiter);
+			else limiter = std::make_unique<limit::InfiniteLimiter>();
+
+			m_ponderTime.reset();
+
+			m_searcher.ponderhit(std::move(limiter));
+		}
+
 		//TODO refactor
 		auto UciHandler::handleSetoption(const std::vector<std::string> &tokens) -> void
 		{
@@ -485,6 +583,34 @@ namespace stormphranj
 							m_searcher.setThreads(search::ThreadCountRange.clamp(*newThreads));
 					}
 				}
+				else if (nameStr == "ponder")
+				{
+					// nothing to do, pondering is driven entirely by the gui
+				}
+				else if (nameStr == "abdada")
+				{
+					if (!valueEmpty)
+					{
+						if (const auto newAbdada = util::tryParseBool(valueStr))
+							m_searcher.setAbdada(*newAbdada);
+					}
+				}
+				else if (nameStr == "threadstats")
+				{
+					if (!valueEmpty)
+					{
+						if (const auto newThreadStats = util::tryParseBool(valueStr))
+							m_searcher.setReportThreadStats(*newThreadStats);
+					}
+				}
+				else if (nameStr == "multipv")
+				{
+					if (!valueEmpty)
+					{
+						if (const auto newMultiPv = util::tryParseU32(valueStr))
+							m_searcher.setMultiPv(search::MultiPvRange.clamp(*newMultiPv));
+					}
+				}
 				else if (nameStr == "contempt")
 				{
 					if (!valueEmpty)
@@ -653,6 +779,11 @@ namespace stormphranj
 			splitPerft(m_pos, static_cast<i32>(depth));
 		}
 
+		auto UciHandler::handlePerftsuite() -> void
+		{
+			perftSuite();
+		}
+
 		auto UciHandler::handleBench(const std::vector<std::string> &tokens) -> void
 		{
 			if (m_searcher.searching())
@@ -709,6 +840,69 @@ namespace stormphranj
 			bench::run(m_searcher, depth);
 		}
 
+		auto UciHandler::handleSmpbench(const std::vector<std::string> &tokens) -> void
+		{
+			if (m_searcher.searching())
+			{
+				std::cerr << "already searching" << std::endl;
+				return;
+			}
+
+			i32 depth = bench::DefaultSmpBenchDepth;
+			u32 threads = bench::DefaultSmpBenchThreads;
+
+			if (tokens.size() > 1)
+			{
+				if (const auto newDepth = util::tryParseU32(tokens[1]))
+					depth = std::max(static_cast<i32>(*newDepth), 1);
+				else
+				{
+					std::cout << "info string invalid depth " << tokens[1] << std::endl;
+					return;
+				}
+			}
+
+			if (tokens.size() > 2)
+			{
+				if (const auto newThreads = util::tryParseU32(tokens[2]))
+					threads = search::ThreadCountRange.clamp(*newThreads);
+				else
+				{
+					std::cout << "info string invalid thread count " << tokens[2] << std::endl;
+					return;
+				}
+			}
+
+			const auto prevThreads = m_searcher.threadCount();
+
+			m_searcher.setThreads(threads);
+			std::cout << "info string set threads to " << threads << std::endl;
+
+			// like bench, every position starts from a new game, so the tt is not preserved
+			bench::runSmp(m_searcher, depth);
+
+			m_searcher.setThreads(prevThreads);
+			std::cout << "info string restored threads to " << prevThreads << std::endl;
+		}
+
+		auto UciHandler::handleMovebench(const std::vector<std::string> &tokens) -> void
+		{
+			u32 iterations = bench::DefaultMoveBenchIterations;
+
+			if (tokens.size() > 1)
+			{
+				if (const auto newIterations = util::tryParseU32(tokens[1]))
+					iterations = std::max(*newIterations, 1U);
+				else
+				{
+					std::cout << "info string invalid iteration count " << tokens[1] << std::endl;
+					return;
+				}
+			}
+
+			bench::runMoves(iterations);
+		}
+
 #ifndef NDEBUG
 		auto UciHandler::handleVerify() -> void
 		{
@@ -0,0 +1,212 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mmap.h"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else // assume posix
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace stormphranj::util
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile &&other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile &
+	{
+		if (this == &other)
+			return *this;
+
+		close();
+
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_open = std::exchange(other.m_open, false);
+
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+
+		return *this;
+	}
+
+#ifdef _WIN32
+	auto MappedFile::open(const std::filesystem::path &path, AccessPattern pattern) -> bool
+	{
+		close();
+
+		DWORD flags = FILE_ATTRIBUTE_NORMAL;
+
+		switch (pattern)
+		{
+		case AccessPattern::Sequential: flags |= FILE_FLAG_SEQUENTIAL_SCAN; break;
+		case AccessPattern::Random: flags |= FILE_FLAG_RANDOM_ACCESS; break;
+		default: break;
+		}
+
+		const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+			nullptr, OPEN_EXISTING, flags, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			std::cerr << "failed to open " << path << std::endl;
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			std::cerr << "failed to get size of " << path << std::endl;
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file = file;
+		m_size = static_cast<usize>(size.QuadPart);
+		m_open = true;
+
+		// cannot map an empty file
+		if (m_size == 0)
+			return true;
+
+		const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (!mapping)
+		{
+			std::cerr << "failed to map " << path << std::endl;
+			close();
+			return false;
+		}
+
+		m_mapping = mapping;
+
+		m_data = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+		if (!m_data)
+		{
+			std::cerr << "failed to map " << path << std::endl;
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	auto MappedFile::close() -> void
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+
+		if (m_mapping)
+			CloseHandle(m_mapping);
+
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+
+		m_size = 0;
+		m_open = false;
+	}
+#else
+	auto MappedFile::open(const std::filesystem::path &path, AccessPattern pattern) -> bool
+	{
+		close();
+
+		const auto fd = ::open(path.c_str(), O_RDONLY);
+
+		if (fd < 0)
+		{
+			std::cerr << "failed to open " << path << std::endl;
+			return false;
+		}
+
+		struct stat st{};
+		if (fstat(fd, &st) != 0)
+		{
+			std::cerr << "failed to get size of " << path << std::endl;
+			::close(fd);
+			return false;
+		}
+
+		m_size = static_cast<usize>(st.st_size);
+		m_open = true;
+
+		// cannot map an empty file
+		if (m_size == 0)
+		{
+			::close(fd);
+			return true;
+		}
+
+		auto *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		// the mapping holds its own reference to the file
+		::close(fd);
+
+		if (data == MAP_FAILED)
+		{
+			std::cerr << "failed to map " << path << std::endl;
+			m_size = 0;
+			m_open = false;
+			return false;
+		}
+
+		switch (pattern)
+		{
+		case AccessPattern::Sequential: madvise(data, m_size, MADV_SEQUENTIAL); break;
+		case AccessPattern::Random: madvise(data, m_size, MADV_RANDOM); break;
+		default: break;
+		}
+
+		m_data = static_cast<const std::byte *>(data);
+
+		return true;
+	}
+
+	auto MappedFile::close() -> void
+	{
+		if (m_data)
+			munmap(const_cast<std::byte *>(m_data), m_size);
+
+		m_data = nullptr;
+		m_size = 0;
+		m_open = false;
+	}
+#endif
+}
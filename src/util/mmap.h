@@ -0,0 +1,78 @@
+/*
+ * Stormphranj, a UCI shatranj engine
+ * Copyright (C) 2024 Ciekce
+ *
+ * Stormphranj is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphranj is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphranj. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <span>
+#include <cstddef>
+#include <filesystem>
+
+namespace stormphranj::util
+{
+	enum class AccessPattern
+	{
+		Normal = 0,
+		Sequential,
+		Random
+	};
+
+	// Read-only memory mapping of an entire file
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile(MappedFile &&other) noexcept;
+
+		auto open(const std::filesystem::path &path, AccessPattern pattern = AccessPattern::Normal) -> bool;
+		auto close() -> void;
+
+		[[nodiscard]] inline auto isOpen() const
+		{
+			return m_open;
+		}
+
+		[[nodiscard]] inline auto size() const
+		{
+			return m_size;
+		}
+
+		[[nodiscard]] inline auto data() const
+		{
+			return std::span<const std::byte>{m_data, m_size};
+		}
+
+		auto operator=(const MappedFile &) -> MappedFile & = delete;
+		auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+
+	private:
+		const std::byte *m_data{};
+		usize m_size{};
+
+		bool m_open{false};
+
+#ifdef _WIN32
+		void *m_file{};
+		void *m_mapping{};
+#endif
+	};
+}